@@ -211,6 +211,7 @@
 %catches(storage::DeviceHasWrongType, storage::NullPointerException) storage::to_xfs(const Device *device);
 
 %catches(storage::Exception) storage::Actiongraph::Actiongraph(const Storage &storage, Devicegraph *lhs, Devicegraph *rhs);
+%catches(storage::NullPointerException) storage::Actiongraph::get_compound_actions(const Device *device) const;
 %catches(storage::Exception) storage::Actiongraph::write_graphviz(const std::string &filename, ActiongraphStyleCallbacks *style_callbacks) const;
 %catches(storage::Exception) storage::Actiongraph::write_graphviz(const std::string &filename, GraphvizFlags flags=GraphvizFlags::NAME, GraphvizFlags tooltip_flags=GraphvizFlags::NONE) const;
 %catches(storage::AlignError) storage::Alignment::align(const Region &region, AlignPolicy align_policy=AlignPolicy::ALIGN_START_AND_END) const;
@@ -283,6 +284,7 @@
 %catches(storage::Exception) storage::Devicegraph::load(const std::string &filename, bool keep_sids);
 %catches(storage::DeviceNotFoundBySid) storage::Devicegraph::remove_device(sid_t sid);
 %catches(storage::Exception) storage::Devicegraph::save(const std::string &filename) const;
+%catches(storage::Exception) storage::Devicegraph::save_binary(const std::string &filename) const;
 %catches(storage::Exception) storage::Devicegraph::write_graphviz(const std::string &filename, DevicegraphStyleCallbacks *style_callbacks, View view) const;
 %catches(storage::Exception) storage::Devicegraph::write_graphviz(const std::string &filename, DevicegraphStyleCallbacks *style_callbacks) const;
 %catches(storage::Exception) storage::Devicegraph::write_graphviz(const std::string &filename, GraphvizFlags flags=GraphvizFlags::NAME, GraphvizFlags tooltip_flags=GraphvizFlags::NONE) const;
@@ -388,6 +390,7 @@
 %catches(storage::LockException, storage::Exception) storage::Storage::Storage(const Environment &environment);
 %catches(storage::Aborted, storage::Exception) storage::Storage::activate(const ActivateCallbacks *activate_callbacks) const;
 %catches(storage::Exception) storage::Storage::calculate_actiongraph();
+%catches(storage::Exception) storage::Storage::calculate_actiongraphs(const std::vector< Devicegraph * > &candidates);
 %catches(storage::Exception) storage::Storage::check(const CheckCallbacks *check_callbacks=nullptr) const;
 %catches(storage::Aborted, storage::Exception) storage::Storage::commit(const CommitOptions &commit_options, const CommitCallbacks *commit_callbacks=nullptr);
 %catches(storage::Aborted, storage::Exception) storage::Storage::commit(const CommitCallbacks *commit_callbacks=nullptr);
@@ -405,6 +408,7 @@
 %catches(storage::Exception) storage::Storage::get_system();
 %catches(storage::Exception) storage::Storage::get_system() const;
 %catches(storage::Aborted, storage::Exception) storage::Storage::probe(const ProbeCallbacks *probe_callbacks=nullptr);
+%catches(storage::Aborted, storage::Exception) storage::Storage::reprobe(const ProbeCallbacks *probe_callbacks=nullptr);
 %catches(storage::Exception) storage::Storage::remove_devicegraph(const std::string &name);
 %catches(storage::Exception) storage::Storage::remove_pool(const std::string &name);
 %catches(storage::Exception) storage::Storage::restore_devicegraph(const std::string &name);
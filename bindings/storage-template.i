@@ -2,6 +2,7 @@
 %template(VectorString) std::vector<std::string>;
 %template(MapStringString) std::map<std::string, std::string>;
 %template(PairBoolString) std::pair<bool, std::string>;
+%template(VectorUnsignedInt) std::vector<unsigned int>;
 
 %template(BtrfsQgroupId) std::pair<unsigned int, unsigned long long>;
 
@@ -111,9 +112,12 @@
 %template(VectorSimpleEtcFstabEntry) std::vector<SimpleEtcFstabEntry>;
 %template(VectorSimpleEtcCrypttabEntry) std::vector<SimpleEtcCrypttabEntry>;
 
+%template(VectorDevicegraphPtr) std::vector<Devicegraph*>;
 %template(VectorConstDevicegraphPtr) std::vector<const Devicegraph*>;
 %template(MapStringConstDevicegraphPtr) std::map<std::string, const Devicegraph*>;
 
 %template(VectorConstPoolPtr) std::vector<const Pool*>;
 %template(MapStringConstPoolPtr) std::map<std::string, const Pool*>;
 
+%template(VectorConstActiongraphPtr) std::vector<const Actiongraph*>;
+
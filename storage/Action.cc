@@ -140,6 +140,17 @@ namespace storage
 	}
 
 
+	bool
+	Create::is_parallelizable(const Actiongraph::Impl& actiongraph) const
+	{
+	    if (!affects_device())
+		return false;
+
+	    const Device* device = get_device(actiongraph);
+	    return device->get_impl().is_create_parallelizable();
+	}
+
+
 	Device*
 	Create::get_device(const Actiongraph::Impl& actiongraph) const
 	{
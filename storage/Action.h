@@ -67,6 +67,13 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const {}
 
+	    /**
+	     * Returns whether the action can be committed in parallel to
+	     * actions affecting other devices. Such an action must only run
+	     * commands on its own devices and must not use the commit data.
+	     */
+	    virtual bool is_parallelizable(const Actiongraph::Impl& actiongraph) const { return false; }
+
 	    /**
 	     * Returns a string representing some information, sid or sid_pair and some
 	     * flags, of the action.
@@ -122,6 +129,8 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
+	    virtual bool is_parallelizable(const Actiongraph::Impl& actiongraph) const override;
+
 	    /**
 	     * Returns the device of the action on the RHS devicegraph. Only valid for
 	     * actions affecting a device.
@@ -149,7 +158,7 @@ namespace storage
 	{
 	public:
 
-	    Modify(sid_t sid, bool only_sync = false) : Base(sid, only_sync) {}
+	    Modify(sid_t sid, bool only_sync = false, bool nop = false) : Base(sid, only_sync, nop) {}
 
 	    /**
 	     * Returns the device of the action on the LHS or RHS devicegraph. Only valid
@@ -24,6 +24,7 @@
 #include "storage/ActiongraphImpl.h"
 #include "storage/Action.h"
 #include "storage/GraphvizImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
 
 
 namespace storage
@@ -35,6 +36,12 @@ namespace storage
     }
 
 
+    Actiongraph::Actiongraph(Impl* impl)
+	: impl(impl)
+    {
+    }
+
+
     Actiongraph::~Actiongraph()
     {
     }
@@ -109,6 +116,15 @@ namespace storage
     }
 
 
+    std::vector<const CompoundAction*>
+    Actiongraph::get_compound_actions(const Device* device) const
+    {
+	ST_CHECK_PTR(device);
+
+	return get_impl().get_compound_actions(this, device->get_sid());
+    }
+
+
     void
     Actiongraph::print_graph() const
     {
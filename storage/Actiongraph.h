@@ -40,6 +40,7 @@ namespace storage
 
     class Storage;
     class Devicegraph;
+    class Device;
 
 
     namespace Action
@@ -139,10 +140,29 @@ namespace storage
 	void generate_compound_actions();
 	std::vector<const CompoundAction*> get_compound_actions() const;
 
+	/**
+	 * Get the compound actions with the given device, or a device
+	 * with the same sid in the other devicegraph, as target device.
+	 *
+	 * The compound actions are generated if generate_compound_actions()
+	 * was not called before. Afterwards the lookup is done via an
+	 * index. The sentences are only computed when
+	 * CompoundAction::sentence() is called, so displaying the compound
+	 * actions of only a few devices is fast even for huge actiongraphs.
+	 *
+	 * @throw NullPointerException
+	 */
+	std::vector<const CompoundAction*> get_compound_actions(const Device* device) const;
+
     public:
 
 	class Impl;
 
+	/**
+	 * Constructor taking ownership of impl.
+	 */
+	Actiongraph(Impl* impl);
+
 	Impl& get_impl() { return *impl; }
 	const Impl& get_impl() const { return *impl; }
 
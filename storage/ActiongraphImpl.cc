@@ -21,6 +21,11 @@
  */
 
 
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
 #include <boost/graph/copy.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/transitive_reduction.hpp>
@@ -29,6 +34,9 @@
 
 #include "storage/Utils/Stopwatch.h"
 #include "storage/Utils/CallbacksImpl.h"
+#include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/Remote.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/PartitionTableImpl.h"
@@ -112,15 +120,6 @@ namespace storage
     }
 
 
-    class CheckCallbacksLogger : public CheckCallbacks
-    {
-    public:
-
-	virtual void error(const string& error) const override;
-
-    };
-
-
     void
     CheckCallbacksLogger::error(const string& error) const
     {
@@ -128,7 +127,8 @@ namespace storage
     }
 
 
-    Actiongraph::Impl::Impl(const Storage& storage, Devicegraph* lhs, Devicegraph* rhs)
+    Actiongraph::Impl::Impl(const Storage& storage, Devicegraph* lhs, Devicegraph* rhs,
+			    bool check_storage)
 	: storage(storage), lhs(lhs), rhs(rhs)
     {
 	if (lhs->get_storage() != &storage || rhs->get_storage() != &storage)
@@ -136,9 +136,12 @@ namespace storage
 
 	set_gpt_undersized();
 
-	CheckCallbacksLogger check_callbacks_logger;
+	if (check_storage)
+	{
+	    CheckCallbacksLogger check_callbacks_logger;
 
-	storage.check(&check_callbacks_logger);
+	    storage.check(&check_callbacks_logger);
+	}
 
 	Stopwatch stopwatch;
 
@@ -488,34 +491,52 @@ namespace storage
     void
     Actiongraph::Impl::remove_duplicates()
     {
-	vector<pair<vertex_descriptor, vertex_descriptor>> duplicates;
+	// Mount and unmount actions are bucketed by sid so that duplicates
+	// are found in linear time. The position of the first action is kept
+	// to merge the duplicates in the order of the vertices.
 
-	boost::iterator_range<vertex_iterator> range = vertices();
+	typedef pair<size_t, vertex_descriptor> first_t;
+
+	unordered_map<sid_t, first_t> mounts;
+	unordered_map<sid_t, first_t> unmounts;
+
+	vector<pair<first_t, vertex_descriptor>> duplicates;
+
+	size_t position = 0;
 
-	for (vertex_iterator it1 = range.begin(); it1 != range.end(); ++it1)
+	for (vertex_descriptor vertex : vertices())
 	{
-	    const Action::Base* action1 = graph[*it1].get();
+	    const Action::Base* action = graph[vertex].get();
+
+	    unordered_map<sid_t, first_t>* firsts = is_mount(action) ? &mounts :
+		is_unmount(action) ? &unmounts : nullptr;
 
-	    for (vertex_iterator it2 = next(it1); it2 != range.end(); ++it2)
+	    if (firsts)
 	    {
-		const Action::Base* action2 = graph[*it2].get();
+		pair<unordered_map<sid_t, first_t>::iterator, bool> tmp =
+		    firsts->emplace(action->sid, first_t(position, vertex));
 
-		if (action1->sid == action2->sid)
-		{
-		    if ((is_mount(action1) && is_mount(action2)) ||
-			(is_unmount(action1) && is_unmount(action2)))
-			duplicates.push_back(make_pair(*it1, *it2));
-		}
+		if (!tmp.second)
+		    duplicates.push_back(make_pair(tmp.first->second, vertex));
 	    }
+
+	    ++position;
 	}
 
-	for (pair<vertex_descriptor, vertex_descriptor> duplicate : duplicates)
+	stable_sort(duplicates.begin(), duplicates.end(),
+		    [](const pair<first_t, vertex_descriptor>& lhs, const pair<first_t, vertex_descriptor>& rhs) {
+			return lhs.first.first < rhs.first.first;
+		    });
+
+	for (const pair<first_t, vertex_descriptor>& duplicate : duplicates)
 	{
+	    vertex_descriptor first = duplicate.first.second;
+
 	    for (vertex_descriptor parent : parents(duplicate.second))
-		add_edge(parent, duplicate.first);
+		add_edge(parent, first);
 
 	    for (vertex_descriptor child : children(duplicate.second))
-		add_edge(duplicate.first, child);
+		add_edge(first, child);
 
 	    clear_vertex(duplicate.second, graph);
 	    remove_vertex(duplicate.second, graph);
@@ -775,6 +796,18 @@ namespace storage
 
 	CommitData commit_data(*this, Tense::PRESENT_CONTINUOUS);
 
+	// Mockup recording and remote callbacks are not thread-safe.
+
+	if (commit_options.parallel_actions > 1 && Mockup::get_mode() != Mockup::Mode::RECORD &&
+	    !get_remote_callbacks())
+	{
+	    commit_in_parallel(commit_data, commit_options, commit_callbacks);
+
+	    y2mil("commit end");
+
+	    return;
+	}
+
 	for (const vertex_descriptor vertex : order)
 	{
 	    const Action::Base* action = graph[vertex].get();
@@ -804,16 +837,357 @@ namespace storage
     }
 
 
+    set<sid_t>
+    Actiongraph::Impl::get_locked_sids(const Action::Base* action) const
+    {
+	vector<sid_t> sids;
+
+	if (action->affects_device())
+	{
+	    sids.push_back(action->sid);
+	}
+	else
+	{
+	    sids.push_back(action->sid_pair.first);
+	    sids.push_back(action->sid_pair.second);
+	}
+
+	set<sid_t> ret;
+
+	for (const Devicegraph* devicegraph : { lhs, rhs })
+	{
+	    for (sid_t sid : sids)
+	    {
+		if (!devicegraph->device_exists(sid))
+		    continue;
+
+		for (const Device* device : devicegraph->find_device(sid)->get_ancestors(true))
+		    ret.insert(device->get_sid());
+	    }
+	}
+
+	return ret;
+    }
+
+
+    namespace
+    {
+
+	/**
+	 * Bookkeeping for an action during a parallel commit.
+	 */
+	struct Job
+	{
+	    Job(Actiongraph::Impl::vertex_descriptor vertex, const Action::Base* action)
+		: vertex(vertex), action(action) {}
+
+	    enum class State { WAITING, RUNNING, DONE };
+
+	    const Actiongraph::Impl::vertex_descriptor vertex;
+	    const Action::Base* action;
+
+	    State state = State::WAITING;
+
+	    bool parallelizable = false;
+
+	    set<sid_t> locked_sids;
+
+	    unsigned int unfinished_parents = 0;
+
+	    Text text;
+
+	    LogBuffer log_buffer;
+
+	    std::exception_ptr exception;
+
+	    std::thread thread;
+	};
+
+    }
+
+
+    void
+    Actiongraph::Impl::commit_in_parallel(CommitData& commit_data, const CommitOptions& commit_options,
+					  const CommitCallbacks* commit_callbacks) const
+    {
+	// Actions are started as soon as all their parents in the
+	// actiongraph are done. Actions affecting the same devices, including
+	// their ancestors, are serialized in the order of the serial
+	// commit. Actions that are not parallelizable are committed by the
+	// calling thread once all previous actions are done. Messages, errors
+	// and log lines of the actions are passed on in that order too.
+
+	y2mil("commit with up to " << commit_options.parallel_actions << " parallel actions");
+
+	vector<Job> jobs;
+	jobs.reserve(order.size());
+
+	map<vertex_descriptor, size_t> indices;
+
+	for (const vertex_descriptor vertex : order)
+	{
+	    indices[vertex] = jobs.size();
+	    jobs.emplace_back(vertex, graph[vertex].get());
+	}
+
+	// For every locked sid the jobs in order. A job may only start when
+	// it is the first unfinished one for all its sids.
+
+	map<sid_t, deque<size_t>> locks;
+
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+	    Job& job = jobs[i];
+
+	    job.parallelizable = !job.action->nop && job.action->is_parallelizable(*this);
+	    job.locked_sids = get_locked_sids(job.action);
+	    job.unfinished_parents = boost::in_degree(job.vertex, graph);
+
+	    for (sid_t sid : job.locked_sids)
+		locks[sid].push_back(i);
+	}
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	vector<size_t> finished;
+
+	unsigned int running = 0;
+
+	size_t next_message = 0;
+	size_t next_retire = 0;
+
+	auto can_start = [&](size_t i) {
+	    const Job& job = jobs[i];
+
+	    if (job.state != Job::State::WAITING || job.unfinished_parents > 0)
+		return false;
+
+	    for (sid_t sid : job.locked_sids)
+		if (locks[sid].front() != i)
+		    return false;
+
+	    return true;
+	};
+
+	auto finish = [&](size_t i) {
+	    Job& job = jobs[i];
+
+	    job.state = Job::State::DONE;
+
+	    for (sid_t sid : job.locked_sids)
+		locks[sid].pop_front();
+
+	    for (vertex_descriptor child : children(job.vertex))
+		--jobs[indices[child]].unfinished_parents;
+	};
+
+	auto start = [&](size_t i) {
+	    Job& job = jobs[i];
+
+	    job.state = Job::State::RUNNING;
+
+	    LogBuffer::Install install(job.log_buffer);
+
+	    job.text = job.action->text(commit_data);
+
+	    y2mil("Commit Action \"" << job.text.native << "\" [" << job.action->details() << "]");
+	};
+
+	auto commit_job = [&commit_data, &commit_options](Job& job) {
+	    LogBuffer::Install install(job.log_buffer);
+
+	    try
+	    {
+		job.action->commit(commit_data, commit_options);
+	    }
+	    catch (const Exception& exception)
+	    {
+		ST_CAUGHT(exception);
+
+		job.exception = std::current_exception();
+	    }
+	    catch (...)
+	    {
+		job.exception = std::current_exception();
+	    }
+	};
+
+	auto wait_for_finished = [&]() {
+	    vector<size_t> tmp;
+
+	    {
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [&finished]() { return !finished.empty(); });
+		tmp.swap(finished);
+	    }
+
+	    for (size_t i : tmp)
+	    {
+		jobs[i].thread.join();
+		finish(i);
+		--running;
+	    }
+	};
+
+	// Passes on the message of the first started job that has no
+	// unretired predecessor and retires finished jobs, both in order.
+	// So callbacks see the same sequence as during a serial commit.
+
+	auto pass_on = [&]() {
+	    bool progress = false;
+
+	    while (true)
+	    {
+		if (next_message == next_retire && next_message < jobs.size() &&
+		    jobs[next_message].state != Job::State::WAITING)
+		{
+		    message_callback(commit_callbacks, jobs[next_message].text);
+
+		    ++next_message;
+		}
+		else if (next_retire < next_message && jobs[next_retire].state == Job::State::DONE)
+		{
+		    Job& job = jobs[next_retire];
+
+		    ++next_retire;
+
+		    job.log_buffer.write();
+
+		    if (job.exception)
+		    {
+			try
+			{
+			    std::rethrow_exception(job.exception);
+			}
+			catch (const Exception& exception)
+			{
+			    error_callback(commit_callbacks, job.text, exception);
+			}
+		    }
+		}
+		else
+		{
+		    break;
+		}
+
+		progress = true;
+	    }
+
+	    return progress;
+	};
+
+	try
+	{
+	    while (next_retire < jobs.size())
+	    {
+		bool progress = pass_on();
+
+		for (size_t i = next_retire; i < jobs.size() && running < commit_options.parallel_actions; ++i)
+		{
+		    if (!can_start(i))
+			continue;
+
+		    Job& job = jobs[i];
+
+		    if (job.parallelizable)
+		    {
+			start(i);
+
+			++running;
+
+			job.thread = std::thread([&commit_job, &job, &mutex, &condition, &finished, i]() {
+			    commit_job(job);
+
+			    std::lock_guard<std::mutex> lock(mutex);
+			    finished.push_back(i);
+			    condition.notify_one();
+			});
+		    }
+		    else if (i == next_retire)
+		    {
+			// Other actions are committed by this thread once all
+			// previous actions are retired, as during a serial
+			// commit.
+
+			start(i);
+			pass_on();
+
+			if (!job.action->nop)
+			    commit_job(job);
+
+			finish(i);
+			pass_on();
+		    }
+		    else
+		    {
+			continue;
+		    }
+
+		    progress = true;
+		}
+
+		if (running > 0)
+		    wait_for_finished();
+		else if (!progress && next_retire < jobs.size())
+		    ST_THROW(LogicException("parallel commit stalled"));
+	    }
+	}
+	catch (...)
+	{
+	    while (running > 0)
+		wait_for_finished();
+
+	    for (; next_retire < jobs.size(); ++next_retire)
+		jobs[next_retire].log_buffer.write();
+
+	    throw;
+	}
+    }
+
+
     void
     Actiongraph::Impl::generate_compound_actions(const Actiongraph* actiongraph)
+    {
+	std::lock_guard<std::mutex> lock(compound_actions_mutex);
+
+	generate_compound_actions_unlocked(actiongraph);
+    }
+
+
+    void
+    Actiongraph::Impl::generate_compound_actions_unlocked(const Actiongraph* actiongraph) const
     {
 	compound_actions = CompoundAction::Generator(actiongraph).generate();
+
+	compound_actions_by_sid.clear();
+	for (const shared_ptr<CompoundAction>& compound_action : compound_actions)
+	    compound_actions_by_sid[compound_action->get_target_device()->get_sid()].push_back(compound_action.get());
+
+	compound_actions_generated = true;
+    }
+
+
+    vector<const CompoundAction*>
+    Actiongraph::Impl::get_compound_actions(const Actiongraph* actiongraph, sid_t sid) const
+    {
+	std::lock_guard<std::mutex> lock(compound_actions_mutex);
+
+	if (!compound_actions_generated)
+	    generate_compound_actions_unlocked(actiongraph);
+
+	auto it = compound_actions_by_sid.find(sid);
+	if (it == compound_actions_by_sid.end())
+	    return {};
+
+	return it->second;
     }
 
 
     vector<const CompoundAction*>
     Actiongraph::Impl::get_compound_actions() const
     {
+	std::lock_guard<std::mutex> lock(compound_actions_mutex);
+
 	vector<const CompoundAction*> ret;
 	for (auto compound_action : compound_actions)
 	    ret.push_back(compound_action.get());
@@ -28,11 +28,14 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/noncopyable.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
 #include "storage/Devices/Device.h"
 #include "storage/Actiongraph.h"
+#include "storage/Storage.h"
 #include "storage/Utils/Text.h"
 #include "storage/CommitOptions.h"
 
@@ -59,6 +62,18 @@ namespace storage
     }
 
 
+    /**
+     * Check callbacks logging the errors.
+     */
+    class CheckCallbacksLogger : public CheckCallbacks
+    {
+    public:
+
+	virtual void error(const string& error) const override;
+
+    };
+
+
     /**
      * Enum to allow filtering of actions in actions_with_sid().
      */
@@ -112,7 +127,11 @@ namespace storage
 
 	typedef graph_t::vertices_size_type vertices_size_type;
 
-	Impl(const Storage& storage, Devicegraph* lhs, Devicegraph* rhs);
+	/**
+	 * If check_storage is false the caller is responsible for calling
+	 * Storage::check() beforehand.
+	 */
+	Impl(const Storage& storage, Devicegraph* lhs, Devicegraph* rhs, bool check_storage = true);
 
 	const Storage& get_storage() const { return storage; }
 
@@ -179,6 +198,13 @@ namespace storage
 	void generate_compound_actions(const Actiongraph* actiongraph);
 	vector<const CompoundAction*> get_compound_actions() const;
 
+	/**
+	 * Get the compound actions with a target device with the given
+	 * sid. The compound actions are generated if that was not done
+	 * before.
+	 */
+	vector<const CompoundAction*> get_compound_actions(const Actiongraph* actiongraph, sid_t sid) const;
+
 	// special flags, TODO make private and provide interface
 	set<sid_t> btrfs_subvolume_delete_is_nop;
 	set<sid_t> btrfs_qgroup_delete_is_nop;
@@ -203,6 +229,15 @@ namespace storage
 	void remove_only_syncs();
 	void calculate_order();
 
+	void commit_in_parallel(CommitData& commit_data, const CommitOptions& commit_options,
+				const CommitCallbacks* commit_callbacks) const;
+
+	/**
+	 * Returns the sids of the devices affected by the action and of all
+	 * their ancestors in both devicegraphs.
+	 */
+	set<sid_t> get_locked_sids(const Action::Base* action) const;
+
 	const Storage& storage;
 
 	Devicegraph* lhs;
@@ -222,7 +257,17 @@ namespace storage
 
 	map<sid_t, vector<vertex_descriptor>> cache_for_actions_with_sid;
 
-	vector<shared_ptr<CompoundAction>> compound_actions;
+	/**
+	 * Generated compound actions and an index from the sid of the
+	 * target device to the compound actions. Mutable since the compound
+	 * actions are generated on demand by get_compound_actions(sid).
+	 */
+	mutable vector<shared_ptr<CompoundAction>> compound_actions;
+	mutable std::unordered_map<sid_t, vector<const CompoundAction*>> compound_actions_by_sid;
+	mutable bool compound_actions_generated = false;
+	mutable std::mutex compound_actions_mutex;
+
+	void generate_compound_actions_unlocked(const Actiongraph* actiongraph) const;
 
     };
 
@@ -32,11 +32,19 @@ namespace storage
     {
     public:
 
-	CommitOptions(bool force_rw)
-	    : force_rw(force_rw) {}
+	CommitOptions(bool force_rw, unsigned int parallel_actions = 1)
+	    : force_rw(force_rw), parallel_actions(parallel_actions) {}
 
 	const bool force_rw;
 
+	/**
+	 * Maximal number of actions committed at the same time. With the
+	 * default of 1 all actions are committed one after another. Only
+	 * some actions, e.g. creating filesystems, can be committed in
+	 * parallel and only if they affect different disks.
+	 */
+	const unsigned int parallel_actions;
+
     };
 
 }
@@ -20,7 +20,7 @@
  */
 
 
-#include <algorithm>
+#include <boost/functional/hash.hpp>
 
 #include "storage/CompoundAction/Generator.h"
 #include "storage/CompoundActionImpl.h"
@@ -43,32 +43,28 @@ namespace storage
     vector<shared_ptr<CompoundAction>>
     CompoundAction::Generator::generate() const
     {
-	vector<CompoundAction*> compound_actions;
+	vector<shared_ptr<CompoundAction>> compound_actions;
+
+	unordered_map<Key, CompoundAction*, KeyHash> index;
 
 	for (const Action::Base* action : actiongraph->get_commit_actions())
 	{
 	    pair<const Device*, CompoundAction::Impl::Type> meta_device = get_meta_device(action);
 
-	    auto compound_action = find_by_target_device(compound_actions, meta_device.first, meta_device.second);
+	    CompoundAction*& compound_action = index[Key(meta_device.first, meta_device.second)];
 
-	    if (compound_action)
-	    {
-		compound_action->get_impl().add_commit_action(action);
-	    }
-	    else
+	    if (!compound_action)
 	    {
-		compound_action = new CompoundAction(actiongraph);
+		compound_actions.push_back(make_shared<CompoundAction>(actiongraph));
+		compound_action = compound_actions.back().get();
 		compound_action->get_impl().set_target_device(meta_device.first);
 		compound_action->get_impl().set_type(meta_device.second);
-		compound_action->get_impl().add_commit_action(action);
-		compound_actions.push_back(compound_action);
 	    }
+
+	    compound_action->get_impl().add_commit_action(action);
 	}
 
-	vector<shared_ptr<CompoundAction>> ret;
-	for (CompoundAction* compound_action : compound_actions)
-	    ret.push_back(shared_ptr<CompoundAction>(compound_action));
-	return ret;
+	return compound_actions;
     }
 
 
@@ -156,21 +152,29 @@ namespace storage
     }
 
 
-    CompoundAction*
-    CompoundAction::Generator::find_by_target_device(const vector<CompoundAction*>& compound_actions,
-						     const Device* device, CompoundAction::Impl::Type type) const
+    CompoundAction::Generator::Key::Key(const Device* device, CompoundAction::Impl::Type type)
+	: devicegraph(device->get_devicegraph()), sid(device->get_sid()), type(type)
+    {
+    }
+
+
+    bool
+    CompoundAction::Generator::Key::operator==(const Key& rhs) const
+    {
+	return devicegraph == rhs.devicegraph && sid == rhs.sid && type == rhs.type;
+    }
+
+
+    size_t
+    CompoundAction::Generator::KeyHash::operator()(const Key& key) const
     {
-	auto begin = compound_actions.begin();
-	auto end = compound_actions.end();
+	size_t seed = 0;
 
-	auto it = find_if(begin, end, [device, type](const CompoundAction* a) -> bool {
-	    return a->get_target_device() == device && a->get_impl().get_type() == type;
-	});
+	boost::hash_combine(seed, key.devicegraph);
+	boost::hash_combine(seed, key.sid);
+	boost::hash_combine(seed, static_cast<int>(key.type));
 
-	if (it != end)
-	    return *it;
-	else
-	    return nullptr;
+	return seed;
     }
 
 }
@@ -25,6 +25,7 @@
 
 
 #include <vector>
+#include <unordered_map>
 
 #include "storage/CompoundActionImpl.h"
 
@@ -35,6 +36,7 @@ namespace storage
 
 
     class Actiongraph;
+    class Devicegraph;
     class Device;
 
     class CompoundAction::Generator
@@ -50,8 +52,26 @@ namespace storage
 
 	pair<const Device*, CompoundAction::Impl::Type> get_meta_device(const Action::Base* action) const;
 
-	CompoundAction* find_by_target_device(const vector<CompoundAction*>& compound_actions,
-					      const Device* device, CompoundAction::Impl::Type type) const;
+	/**
+	 * Key to find the compound action for a target device and type. The
+	 * devicegraph is part of the key since the target device can be in
+	 * the LHS or the RHS devicegraph.
+	 */
+	struct Key
+	{
+	    Key(const Device* device, CompoundAction::Impl::Type type);
+
+	    bool operator==(const Key& rhs) const;
+
+	    const Devicegraph* devicegraph;
+	    sid_t sid;
+	    CompoundAction::Impl::Type type;
+	};
+
+	struct KeyHash
+	{
+	    size_t operator()(const Key& key) const;
+	};
 
 	const Actiongraph* actiongraph = nullptr;
 
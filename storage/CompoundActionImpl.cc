@@ -266,7 +266,7 @@ namespace storage
     const CompoundAction*
     CompoundAction::Impl::find_by_target_device(const Actiongraph* actiongraph, const Device* device)
     {
-	for (auto action : actiongraph->get_compound_actions())
+	for (auto action : actiongraph->get_compound_actions(device))
 	{
 	    if (action->get_target_device() == device)
 		return action;
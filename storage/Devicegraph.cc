@@ -21,7 +21,9 @@
  */
 
 
-#include <boost/graph/copy.hpp>
+#include <unordered_map>
+#include <boost/graph/depth_first_search.hpp>
+#include <boost/graph/breadth_first_search.hpp>
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/graph_utility.hpp>
@@ -176,6 +178,13 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::save_binary(const string& filename) const
+    {
+	get_impl().save_binary(filename);
+    }
+
+
     bool
     Devicegraph::empty() const
     {
@@ -267,40 +276,6 @@ namespace storage
     }
 
 
-    class CloneCopier
-    {
-
-    public:
-
-	CloneCopier(const Devicegraph& g_in, Devicegraph& g_out)
-	    : g_in(g_in), g_out(g_out) {}
-
-	void operator()(const Devicegraph::Impl::vertex_descriptor& v_in,
-			Devicegraph::Impl::vertex_descriptor& v_out)
-	{
-	    g_out.get_impl().graph[v_out].reset(g_in.get_impl().graph[v_in]->clone());
-
-	    Device* d_out = g_out.get_impl().graph[v_out].get();
-	    d_out->get_impl().set_devicegraph_and_vertex(&g_out, v_out);
-	}
-
-	void operator()(const Devicegraph::Impl::edge_descriptor& e_in,
-			Devicegraph::Impl::edge_descriptor& e_out)
-	{
-	    g_out.get_impl().graph[e_out].reset(g_in.get_impl().graph[e_in]->clone());
-
-	    Holder* h_out = g_out.get_impl().graph[e_out].get();
-	    h_out->get_impl().set_devicegraph_and_edge(&g_out, e_out);
-	}
-
-    private:
-
-	const Devicegraph& g_in;
-	Devicegraph& g_out;
-
-    };
-
-
     Device*
     Devicegraph::find_device(sid_t sid)
     {
@@ -436,15 +411,38 @@ namespace storage
     void
     Devicegraph::copy(Devicegraph& dest) const
     {
-	dest.get_impl().clear();
+	// Copy vertices and edges directly instead of using boost::copy_graph
+	// which needs a vertex index map and a second pass to build the sid
+	// indices of the destination. Since the vertices are copied in order
+	// the order of vertices() is kept.
 
-	VertexIndexMapGenerator<Impl::graph_t> vertex_index_map_generator(get_impl().graph);
+	const Impl& src_impl = get_impl();
+	Impl& dest_impl = dest.get_impl();
 
-	CloneCopier copier(*this, dest);
+	dest_impl.clear();
+	dest_impl.reserve(src_impl.num_devices(), src_impl.num_holders());
 
-	boost::copy_graph(get_impl().graph, dest.get_impl().graph,
-			  vertex_index_map(vertex_index_map_generator.get()).
-			  vertex_copy(copier).edge_copy(copier));
+	std::unordered_map<Impl::vertex_descriptor, Impl::vertex_descriptor> vertex_map;
+	vertex_map.reserve(src_impl.num_devices());
+
+	for (Impl::vertex_descriptor v_in : src_impl.vertices())
+	{
+	    Device* d_out = src_impl[v_in]->clone();
+
+	    Impl::vertex_descriptor v_out = dest_impl.add_vertex(d_out);
+	    d_out->get_impl().set_devicegraph_and_vertex(&dest, v_out);
+
+	    vertex_map.emplace(v_in, v_out);
+	}
+
+	for (Impl::edge_descriptor e_in : src_impl.edges())
+	{
+	    Holder* h_out = src_impl[e_in]->clone();
+
+	    Impl::edge_descriptor e_out = dest_impl.add_edge(vertex_map[src_impl.source(e_in)],
+							     vertex_map[src_impl.target(e_in)], h_out);
+	    h_out->get_impl().set_devicegraph_and_edge(&dest, e_out);
+	}
     }
 
 
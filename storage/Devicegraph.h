@@ -198,7 +198,8 @@ namespace storage
 	void load(const std::string& filename);
 
 	/**
-	 * Load the devicegraph from a file.
+	 * Load the devicegraph from a file. The file can be in XML or in
+	 * the binary format, see save_binary().
 	 *
 	 * @throw Exception
 	 */
@@ -211,6 +212,17 @@ namespace storage
 	 */
 	void save(const std::string& filename) const;
 
+	/**
+	 * Save the devicegraph to a file in a compact binary format. The
+	 * format is versioned and load() rejects files written by newer
+	 * versions of the library with an incompatible format. The file
+	 * contains the same information as the XML file from save(). It
+	 * is much faster to load but not human readable.
+	 *
+	 * @throw Exception
+	 */
+	void save_binary(const std::string& filename) const;
+
 	/**
 	 * Query whether the devicegraph is empty.
 	 */
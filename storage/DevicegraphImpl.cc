@@ -25,10 +25,14 @@
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/graph_utility.hpp>
+#include <boost/range/distance.hpp>
+#include <boost/algorithm/string/join.hpp>
 
 #include "storage/DevicegraphImpl.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
+#include "storage/Utils/LoggerImpl.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/Disk.h"
 #include "storage/Filesystems/Nfs.h"
@@ -319,10 +323,39 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	/**
+	 * Takes ownership of the device or holder. With
+	 * ENABLE_POOLED_GRAPH the control block of the shared_ptr is
+	 * allocated from a memory pool like the nodes of the graph.
+	 */
+	template <typename Type>
+	shared_ptr<Type>
+	make_property(Type* p)
+	{
+#ifdef ENABLE_POOLED_GRAPH
+	    return shared_ptr<Type>(p, std::default_delete<Type>(), boost::fast_pool_allocator<Type>());
+#else
+	    return shared_ptr<Type>(p);
+#endif
+	}
+
+    }
+
+
     Devicegraph::Impl::vertex_descriptor
     Devicegraph::Impl::add_vertex(Device* device)
     {
-	return boost::add_vertex(shared_ptr<Device>(device), graph);
+	vertex_descriptor vertex = boost::add_vertex(make_property(device), graph);
+
+	vertex_index.emplace(device->get_sid(), vertex);
+
+	index_keys[vertex].position = next_position++;
+	update_indices(vertex);
+
+	return vertex;
     }
 
 
@@ -343,13 +376,15 @@ namespace storage
 	}
 
 	pair<Devicegraph::Impl::edge_descriptor, bool> tmp =
-	    boost::add_edge(source_vertex, target_vertex, shared_ptr<Holder>(holder), graph);
+	    boost::add_edge(source_vertex, target_vertex, make_property(holder), graph);
 
 	// Since parallel edges are allowed tmp.second must always be true.
 
 	if (!tmp.second)
 	    ST_THROW(LogicException("boost::add_edge behaved unexpectedly"));
 
+	edge_index[make_pair(source_sid, target_sid)].push_back(tmp.first);
+
 	// TODO should also set devicegraph and edge in holder but the
 	// devicegraph is not available here
 
@@ -384,40 +419,25 @@ namespace storage
     bool
     Devicegraph::Impl::device_exists(sid_t sid) const
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return true;
-	}
-
-	return false;
+	return vertex_index.find(sid) != vertex_index.end();
     }
 
 
     bool
     Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
     {
-	for (edge_descriptor edge : edges())
-	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return true;
-	}
-
-	return false;
+	return edge_index.find(make_pair(source_sid, target_sid)) != edge_index.end();
     }
 
 
     Devicegraph::Impl::vertex_descriptor
     Devicegraph::Impl::find_vertex(sid_t sid) const
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return vertex;
-	}
+	std::unordered_map<sid_t, vertex_descriptor>::const_iterator it = vertex_index.find(sid);
+	if (it == vertex_index.end())
+	    ST_THROW(DeviceNotFoundBySid(sid));
 
-	ST_THROW(DeviceNotFoundBySid(sid));
+	return it->second;
     }
 
 
@@ -439,23 +459,166 @@ namespace storage
     vector<Devicegraph::Impl::edge_descriptor>
     Devicegraph::Impl::find_edges(sid_t source_sid, sid_t target_sid) const
     {
-	vector<Devicegraph::Impl::edge_descriptor> ret;
+	auto it = edge_index.find(make_pair(source_sid, target_sid));
+	if (it == edge_index.end())
+	    return {};
 
-	for (edge_descriptor edge : edges())
+	return it->second;
+    }
+
+
+    vector<Devicegraph::Impl::edge_descriptor>
+    Devicegraph::Impl::find_edges(sid_pair_t sid_pair) const
+    {
+	return find_edges(sid_pair.first, sid_pair.second);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices(const std::unordered_map<string, vector<vertex_descriptor>>& index,
+				     const string& key) const
+    {
+	auto it = index.find(key);
+	if (it == index.end())
+	    return {};
+
+	vector<vertex_descriptor> ret = it->second;
+
+	if (ret.size() > 1)
 	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		ret.push_back(edge);
+	    sort(ret.begin(), ret.end(), [this](vertex_descriptor lhs, vertex_descriptor rhs) {
+		return index_keys.at(lhs).position < index_keys.at(rhs).position;
+	    });
 	}
 
 	return ret;
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
-    Devicegraph::Impl::find_edges(sid_pair_t sid_pair) const
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_name(const string& name) const
     {
-	return find_edges(sid_pair.first, sid_pair.second);
+	return find_vertices(name_index, name);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_sysfs_path(const string& sysfs_path) const
+    {
+	return find_vertices(sysfs_path_index, sysfs_path);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_uuid(const string& uuid) const
+    {
+	return find_vertices(uuid_index, uuid);
+    }
+
+
+    namespace
+    {
+
+	void
+	remove_from_index(std::unordered_map<string, vector<Devicegraph::Impl::vertex_descriptor>>& index,
+			  const string& key, Devicegraph::Impl::vertex_descriptor vertex)
+	{
+	    if (key.empty())
+		return;
+
+	    auto it = index.find(key);
+	    if (it == index.end())
+		return;
+
+	    vector<Devicegraph::Impl::vertex_descriptor>& tmp = it->second;
+	    tmp.erase(remove(tmp.begin(), tmp.end(), vertex), tmp.end());
+
+	    if (tmp.empty())
+		index.erase(it);
+	}
+
+
+	void
+	add_to_index(std::unordered_map<string, vector<Devicegraph::Impl::vertex_descriptor>>& index,
+		     const string& key, Devicegraph::Impl::vertex_descriptor vertex)
+	{
+	    if (key.empty())
+		return;
+
+	    index[key].push_back(vertex);
+	}
+
+    }
+
+
+    void
+    Devicegraph::Impl::update_indices(vertex_descriptor vertex)
+    {
+	// Vertices not yet known to the indices, e.g. during
+	// Devicegraph::copy, are handled by rebuild_indices().
+
+	auto it = index_keys.find(vertex);
+	if (it == index_keys.end())
+	    return;
+
+	const Device::Impl& device_impl = graph[vertex]->get_impl();
+
+	IndexKeys& keys = it->second;
+
+	if (keys.classname.empty())
+	{
+	    keys.classname = device_impl.get_classname();
+	    type_index[keys.classname][keys.position] = vertex;
+	}
+
+	string name = device_impl.get_name_index_key();
+	if (name != keys.name)
+	{
+	    remove_from_index(name_index, keys.name, vertex);
+	    add_to_index(name_index, name, vertex);
+	    keys.name = name;
+	}
+
+	string sysfs_path = device_impl.get_sysfs_path_index_key();
+	if (sysfs_path != keys.sysfs_path)
+	{
+	    remove_from_index(sysfs_path_index, keys.sysfs_path, vertex);
+	    add_to_index(sysfs_path_index, sysfs_path, vertex);
+	    keys.sysfs_path = sysfs_path;
+	}
+
+	string uuid = device_impl.get_uuid_index_key();
+	if (uuid != keys.uuid)
+	{
+	    remove_from_index(uuid_index, keys.uuid, vertex);
+	    add_to_index(uuid_index, uuid, vertex);
+	    keys.uuid = uuid;
+	}
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_indices(vertex_descriptor vertex)
+    {
+	auto it = index_keys.find(vertex);
+	if (it == index_keys.end())
+	    return;
+
+	const IndexKeys& keys = it->second;
+
+	auto it2 = type_index.find(keys.classname);
+	if (it2 != type_index.end())
+	{
+	    it2->second.erase(keys.position);
+	    if (it2->second.empty())
+		type_index.erase(it2);
+	}
+
+	remove_from_index(name_index, keys.name, vertex);
+	remove_from_index(sysfs_path_index, keys.sysfs_path, vertex);
+	remove_from_index(uuid_index, keys.uuid, vertex);
+
+	index_keys.erase(it);
     }
 
 
@@ -507,12 +670,46 @@ namespace storage
     Devicegraph::Impl::clear()
     {
 	graph.clear();
+
+	vertex_index.clear();
+	edge_index.clear();
+
+	next_position = 0;
+	index_keys.clear();
+	type_index.clear();
+	name_index.clear();
+	sysfs_path_index.clear();
+	uuid_index.clear();
+    }
+
+
+    void
+    Devicegraph::Impl::reserve(size_t num_devices, size_t num_holders)
+    {
+	vertex_index.reserve(num_devices);
+	edge_index.reserve(num_holders);
+
+	index_keys.reserve(num_devices);
+	name_index.reserve(num_devices);
+	sysfs_path_index.reserve(num_devices);
     }
 
 
     void
     Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
     {
+	for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	    remove_from_edge_index(edge);
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	    remove_from_edge_index(edge);
+
+	std::unordered_map<sid_t, vertex_descriptor>::iterator it = vertex_index.find(graph[vertex]->get_sid());
+	if (it != vertex_index.end() && it->second == vertex)
+	    vertex_index.erase(it);
+
+	remove_from_indices(vertex);
+
 	boost::clear_vertex(vertex, graph);
 	boost::remove_vertex(vertex, graph);
     }
@@ -521,25 +718,164 @@ namespace storage
     void
     Devicegraph::Impl::remove_edge(edge_descriptor edge)
     {
+	remove_from_edge_index(edge);
+
 	boost::remove_edge(edge, graph);
     }
 
 
+    void
+    Devicegraph::Impl::add_to_edge_index(edge_descriptor edge)
+    {
+	sid_pair_t sid_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid());
+
+	edge_index[sid_pair].push_back(edge);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_edge_index(edge_descriptor edge)
+    {
+	sid_pair_t sid_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid());
+
+	auto it = edge_index.find(sid_pair);
+	if (it == edge_index.end())
+	    return;
+
+	vector<edge_descriptor>& tmp = it->second;
+	tmp.erase(remove(tmp.begin(), tmp.end(), edge), tmp.end());
+
+	if (tmp.empty())
+	    edge_index.erase(it);
+    }
+
+
+    void
+    Devicegraph::Impl::rebuild_indices()
+    {
+	vertex_index.clear();
+	edge_index.clear();
+
+	next_position = 0;
+	index_keys.clear();
+	type_index.clear();
+	name_index.clear();
+	sysfs_path_index.clear();
+	uuid_index.clear();
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    vertex_index.emplace(graph[vertex]->get_sid(), vertex);
+
+	    index_keys[vertex].position = next_position++;
+	    update_indices(vertex);
+	}
+
+	for (edge_descriptor edge : edges())
+	    add_to_edge_index(edge);
+    }
+
+
+    namespace
+    {
+
+	/**
+	 * Key identifying a device across probes without using its sid, see
+	 * Devicegraph::Impl::adopt_sids(). The keys of the parents are
+	 * included since e.g. filesystems and partition tables only have
+	 * generic displaynames.
+	 */
+	const string&
+	identity_key(const Devicegraph::Impl& devicegraph, Devicegraph::Impl::vertex_descriptor vertex,
+		     map<Devicegraph::Impl::vertex_descriptor, string>& keys)
+	{
+	    map<Devicegraph::Impl::vertex_descriptor, string>::const_iterator it = keys.find(vertex);
+	    if (it != keys.end())
+		return it->second;
+
+	    vector<string> parent_keys;
+	    for (Devicegraph::Impl::vertex_descriptor parent : devicegraph.parents(vertex))
+		parent_keys.push_back(identity_key(devicegraph, parent, keys));
+
+	    sort(parent_keys.begin(), parent_keys.end());
+
+	    const Device* device = devicegraph[vertex];
+
+	    string key = string(device->get_impl().get_classname()) + " " + device->get_displayname() +
+		" [" + boost::join(parent_keys, ", ") + "]";
+
+	    return keys[vertex] = key;
+	}
+
+
+	/**
+	 * Identity keys of all devices. Keys that are ambiguous in the
+	 * devicegraph are dropped.
+	 */
+	map<string, Devicegraph::Impl::vertex_descriptor>
+	unique_identity_keys(const Devicegraph::Impl& devicegraph)
+	{
+	    map<Devicegraph::Impl::vertex_descriptor, string> keys;
+
+	    map<string, Devicegraph::Impl::vertex_descriptor> ret;
+	    set<string> ambiguous;
+
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph.vertices())
+	    {
+		const string& key = identity_key(devicegraph, vertex, keys);
+
+		if (!ret.emplace(key, vertex).second)
+		    ambiguous.insert(key);
+	    }
+
+	    for (const string& key : ambiguous)
+		ret.erase(key);
+
+	    return ret;
+	}
+
+    }
+
+
+    void
+    Devicegraph::Impl::adopt_sids(const Impl& previous)
+    {
+	const map<string, vertex_descriptor> previous_keys = unique_identity_keys(previous);
+
+	unsigned int adopted = 0;
+
+	for (const map<string, vertex_descriptor>::value_type& tmp : unique_identity_keys(*this))
+	{
+	    map<string, vertex_descriptor>::const_iterator it = previous_keys.find(tmp.first);
+	    if (it == previous_keys.end())
+		continue;
+
+	    graph[tmp.second]->get_impl().set_sid(previous[it->second]->get_sid());
+
+	    ++adopted;
+	}
+
+	y2mil("adopted sids of " << adopted << " of " << num_devices() << " devices");
+
+	rebuild_indices();
+    }
+
+
     size_t
     Devicegraph::Impl::num_children(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	return boost::out_degree(vertex, filtered_graph);
+	return with_view(view, [this, vertex](auto tag) {
+	    return (size_t) boost::distance(out_edges_range<decltype(tag)::value>(vertex));
+	});
     }
 
 
     size_t
     Devicegraph::Impl::num_parents(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	return boost::in_degree(vertex, filtered_graph);
+	return with_view(view, [this, vertex](auto tag) {
+	    return (size_t) boost::distance(in_edges_range<decltype(tag)::value>(vertex));
+	});
     }
 
 
@@ -560,45 +896,43 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::children(vertex_descriptor vertex, View view) const
     {
-	vector<vertex_descriptor> ret;
-
-	for (edge_descriptor edge : out_edges(vertex, view))
-	    ret.push_back(target(edge));
-
-	return ret;
+	return with_view(view, [this, vertex](auto tag) {
+	    auto range = children_range<decltype(tag)::value>(vertex);
+	    return vector<vertex_descriptor>(range.begin(), range.end());
+	});
     }
 
 
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::parents(vertex_descriptor vertex, View view) const
     {
-	vector<vertex_descriptor> ret;
-
-	for (edge_descriptor edge : in_edges(vertex, view))
-	    ret.push_back(source(edge));
-
-	return ret;
+	return with_view(view, [this, vertex](auto tag) {
+	    auto range = parents_range<decltype(tag)::value>(vertex);
+	    return vector<vertex_descriptor>(range.begin(), range.end());
+	});
     }
 
 
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::siblings(vertex_descriptor vertex, bool itself, View view) const
     {
-	vector<vertex_descriptor> ret;
+	return with_view(view, [this, vertex, itself](auto tag) {
+	    vector<vertex_descriptor> ret;
 
-	for (vertex_descriptor parent : parents(vertex, view))
-	{
-	    for (vertex_descriptor child : children(parent, view))
+	    for (vertex_descriptor parent : parents_range<decltype(tag)::value>(vertex))
 	    {
-		if (itself || vertex != child)
-		    ret.push_back(child);
+		for (vertex_descriptor child : children_range<decltype(tag)::value>(parent))
+		{
+		    if (itself || vertex != child)
+			ret.push_back(child);
+		}
 	    }
-	}
 
-	sort(ret.begin(), ret.end());
-	ret.erase(unique(ret.begin(), ret.end()), ret.end());
+	    sort(ret.begin(), ret.end());
+	    ret.erase(unique(ret.begin(), ret.end()), ret.end());
 
-	return ret;
+	    return ret;
+	});
     }
 
 
@@ -691,108 +1025,191 @@ namespace storage
     Devicegraph::Impl::edge_descriptor
     Devicegraph::Impl::in_edge(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	boost::iterator_range<filtered_graph_t::in_edge_iterator> range =
-	    boost::make_iterator_range(boost::in_edges(vertex, filtered_graph));
+	return with_view(view, [this, vertex](auto tag) {
+	    auto range = in_edges_range<decltype(tag)::value>(vertex);
 
-	size_t size = distance(range.begin(), range.end());
-	if (size != 1)
-	    ST_THROW(WrongNumberOfParents(size, 1));
+	    size_t size = boost::distance(range);
+	    if (size != 1)
+		ST_THROW(WrongNumberOfParents(size, 1));
 
-	return range.front();
+	    return range.front();
+	});
     }
 
 
     Devicegraph::Impl::edge_descriptor
     Devicegraph::Impl::out_edge(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	boost::iterator_range<filtered_graph_t::out_edge_iterator> range =
-	    boost::make_iterator_range(boost::out_edges(vertex, filtered_graph));
+	return with_view(view, [this, vertex](auto tag) {
+	    auto range = out_edges_range<decltype(tag)::value>(vertex);
 
-	size_t size = distance(range.begin(), range.end());
-	if (size != 1)
-	    ST_THROW(WrongNumberOfChildren(size, 1));
+	    size_t size = boost::distance(range);
+	    if (size != 1)
+		ST_THROW(WrongNumberOfChildren(size, 1));
 
-	return range.front();
+	    return range.front();
+	});
     }
 
 
     vector<Devicegraph::Impl::edge_descriptor>
     Devicegraph::Impl::in_edges(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	boost::iterator_range<filtered_graph_t::in_edge_iterator> range =
-	    boost::make_iterator_range(boost::in_edges(vertex, filtered_graph));
-
-	return vector<edge_descriptor>(range.begin(), range.end());
+	return with_view(view, [this, vertex](auto tag) {
+	    auto range = in_edges_range<decltype(tag)::value>(vertex);
+	    return vector<edge_descriptor>(range.begin(), range.end());
+	});
     }
 
 
     vector<Devicegraph::Impl::edge_descriptor>
     Devicegraph::Impl::out_edges(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
+	return with_view(view, [this, vertex](auto tag) {
+	    auto range = out_edges_range<decltype(tag)::value>(vertex);
+	    return vector<edge_descriptor>(range.begin(), range.end());
+	});
+    }
 
-	boost::iterator_range<filtered_graph_t::out_edge_iterator> range =
-	    boost::make_iterator_range(boost::out_edges(vertex, filtered_graph));
 
-	return vector<edge_descriptor>(range.begin(), range.end());
+    bool
+    Devicegraph::Impl::is_in_view(const Device* device, View view)
+    {
+	return device->get_impl().is_in_view(view);
     }
 
 
-    void
-    Devicegraph::Impl::load(Devicegraph* devicegraph, const string& filename, bool keep_sids)
+    bool
+    Devicegraph::Impl::is_in_view(const Holder* holder, View view)
     {
-	if (&devicegraph->get_impl() != this)
-	    ST_THROW(LogicException("wrong impl-ptr"));
+	return holder->get_impl().is_in_view(view);
+    }
+
+
+    namespace
+    {
+
+	const char binary_magic[8] = { 'L', 'S', 'N', 'G', '-', 'D', 'G', '\n' };
+
+	/**
+	 * Version of the binary format. Must be increased whenever the
+	 * format changes in a way older versions cannot read.
+	 */
+	const unsigned int binary_version = 1;
+
+	enum : char { RECORD_DEVICE = 'D', RECORD_HOLDER = 'H' };
 
-	clear();
 
-	XmlFile xml(filename);
+	void
+	load_device(Devicegraph* devicegraph, const string& classname, const xmlNode* node)
+	{
+	    map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
+	    if (it == device_load_registry.end())
+		ST_THROW(Exception(sformat("unknown device class name %s", classname)));
 
-	const xmlNode* root_node = xml.getRootElement();
-	if (!root_node)
-	    ST_THROW(Exception("root node not found"));
+	    const Device* device = it->second(devicegraph, node);
+	    Storage::Impl::raise_global_sid(device->get_sid());
+	}
 
-	const xmlNode* devicegraph_node = getChildNode(root_node, "Devicegraph");
-	if (!devicegraph_node)
-	    ST_THROW(Exception("Devicegraph node not found"));
 
-	const xmlNode* devices_node = getChildNode(devicegraph_node, "Devices");
-	if (devices_node)
+	void
+	load_holder(Devicegraph* devicegraph, const string& classname, const xmlNode* node)
 	{
-	    for (const xmlNode* device_node : getChildNodes(devices_node))
+	    map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
+	    if (it == holder_load_registry.end())
+		ST_THROW(Exception(sformat("unknown holder class name %s", classname)));
+
+	    it->second(devicegraph, node);
+	}
+
+
+	void
+	load_xml(Devicegraph* devicegraph, const string& filename)
+	{
+	    // The file is read element by element so that only the subtree of
+	    // one device or holder is in memory at a time.
+
+	    XmlFileReader reader(filename);
+
+	    string section;
+
+	    while (reader.next_element())
 	    {
-		const string& classname = (const char*) device_node->parent->name;
+		const int depth = reader.depth();
 
-		map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
-		if (it == device_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown device class name %s", classname)));
+		if (depth == 0)
+		{
+		    if (reader.name() != "Devicegraph")
+			ST_THROW(Exception("Devicegraph node not found"));
+		}
+		else if (depth == 1)
+		{
+		    section = reader.name();
+		}
+		else if (depth == 2)
+		{
+		    const string classname = reader.name();
+
+		    const xmlNode* node = reader.expand();
+		    if (!node)
+			continue;
 
-		const Device* device = it->second(devicegraph, device_node);
-		Storage::Impl::raise_global_sid(device->get_sid());
+		    if (section == "Devices")
+			load_device(devicegraph, classname, node);
+		    else if (section == "Holders")
+			load_holder(devicegraph, classname, node);
+		}
 	    }
 	}
 
-	const xmlNode* holders_node = getChildNode(devicegraph_node, "Holders");
-	if (holders_node)
+
+	void
+	load_binary(Devicegraph* devicegraph, const string& filename)
 	{
-	    for (const xmlNode* holder_node : getChildNodes(holders_node))
+	    BinaryFileReader reader(filename, binary_magic, binary_version);
+
+	    char type;
+	    const xmlNode* node;
+
+	    while (reader.next_record(type, node))
 	    {
-		const string& classname = (const char*) holder_node->parent->name;
+		if (!node)
+		    continue;
+
+		const string classname = (const char*) node->parent->name;
+
+		switch (type)
+		{
+		    case RECORD_DEVICE:
+			load_device(devicegraph, classname, node);
+			break;
 
-		map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
-		if (it == holder_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown holder class name %s", classname)));
+		    case RECORD_HOLDER:
+			load_holder(devicegraph, classname, node);
+			break;
 
-		it->second(devicegraph, holder_node);
+		    default:
+			ST_THROW(Exception(sformat("unknown record type in '%s'", filename)));
+		}
 	    }
 	}
 
+    }
+
+
+    void
+    Devicegraph::Impl::load(Devicegraph* devicegraph, const string& filename, bool keep_sids)
+    {
+	if (&devicegraph->get_impl() != this)
+	    ST_THROW(LogicException("wrong impl-ptr"));
+
+	clear();
+
+	if (BinaryFileReader::has_magic(filename, binary_magic))
+	    load_binary(devicegraph, filename);
+	else
+	    load_xml(devicegraph, filename);
+
 	if (!keep_sids)
 	{
 	    for (vertex_descriptor vertex : vertices())
@@ -800,6 +1217,8 @@ namespace storage
 		Device* device = graph[vertex].get();
 		device->get_impl().set_sid(Storage::Impl::get_next_sid());
 	    }
+
+	    rebuild_indices();
 	}
     }
 
@@ -807,34 +1226,67 @@ namespace storage
     void
     Devicegraph::Impl::save(const string& filename) const
     {
-	XmlFile xml;
+	// The file is written device by device so that only the nodes of one
+	// device or holder are in memory at a time.
+
+	XmlFileWriter writer(filename);
 
-	xmlNode* devicegraph_node = xmlNewNode("Devicegraph");
-	xml.setRootElement(devicegraph_node);
+	writer.write_comment(" " + generated_string() + " ");
 
-	xmlNode* comment = xmlNewComment(string(" " + generated_string() + " ").c_str());
-	xmlAddPrevSibling(devicegraph_node, comment);
+	writer.start_element("Devicegraph");
 
-	xmlNode* devices_node = xmlNewChild(devicegraph_node, "Devices");
+	writer.start_element("Devices");
 
 	for (vertex_descriptor vertex : vertices())
 	{
 	    const Device* device = graph[vertex].get();
-	    xmlNode* device_node = xmlNewChild(devices_node, device->get_impl().get_classname());
+	    xmlNode* device_node = xmlNewNode(device->get_impl().get_classname());
 	    device->get_impl().save(device_node);
+	    writer.write_node(device_node);
 	}
 
-	xmlNode* holders_node = xmlNewChild(devicegraph_node, "Holders");
+	writer.end_element();
+
+	writer.start_element("Holders");
 
 	for (edge_descriptor edge : edges())
 	{
 	    const Holder* holder = graph[edge].get();
-	    xmlNode* holder_node = xmlNewChild(holders_node, holder->get_impl().get_classname());
+	    xmlNode* holder_node = xmlNewNode(holder->get_impl().get_classname());
 	    holder->get_impl().save(holder_node);
+	    writer.write_node(holder_node);
 	}
 
-	if (!xml.save_to_file(filename))
-	    ST_THROW(Exception(sformat("failed to write '%s'", filename)));
+	writer.end_element();
+
+	writer.end_element();
+
+	writer.close();
+    }
+
+
+    void
+    Devicegraph::Impl::save_binary(const string& filename) const
+    {
+	BinaryFileWriter writer(filename, binary_magic, binary_version);
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    const Device* device = graph[vertex].get();
+	    xmlNode* device_node = xmlNewNode(device->get_impl().get_classname());
+	    device->get_impl().save(device_node);
+	    writer.write_record(RECORD_DEVICE, device_node);
+	}
+
+	for (edge_descriptor edge : edges())
+	{
+	    const Holder* holder = graph[edge].get();
+	    xmlNode* holder_node = xmlNewNode(holder->get_impl().get_classname());
+	    holder->get_impl().save(holder_node);
+	    writer.write_record(RECORD_HOLDER, holder_node);
+	}
+
+	writer.close();
     }
 
 
@@ -954,8 +1406,7 @@ namespace storage
     {
 	// graph is needed by reference and view by value
 	return [&, view](Devicegraph::Impl::vertex_descriptor vertex) {
-	    const Device* device = graph[vertex].get();
-	    return device->get_impl().is_in_view(view);
+	    return is_in_view(graph[vertex].get(), view);
 	};
     }
 
@@ -965,8 +1416,7 @@ namespace storage
     {
 	// graph is needed by reference and view by value
 	return [&, view](Devicegraph::Impl::edge_descriptor edge) {
-	    const Holder* holder = graph[edge].get();
-	    return holder->get_impl().is_in_view(view);
+	    return is_in_view(graph[edge].get(), view);
 	};
     }
 
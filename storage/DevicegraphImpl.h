@@ -25,15 +25,26 @@
 #define STORAGE_DEVICEGRAPH_IMPL_H
 
 
+#include "config.h"
+
 #include <set>
+#include <map>
+#include <unordered_map>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/filtered_graph.hpp>
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#ifdef ENABLE_POOLED_GRAPH
+#include <boost/pool/pool_alloc.hpp>
+#endif
 
 #include "storage/Devices/Device.h"
 #include "storage/Holders/Holder.h"
 #include "storage/Devicegraph.h"
 #include "storage/View.h"
+#include "storage/Utils/ExceptionImpl.h"
 
 
 namespace storage
@@ -47,6 +58,48 @@ namespace storage
     using sid_pair_t = pair<sid_t, sid_t>;
 
 
+#ifdef ENABLE_POOLED_GRAPH
+
+    /**
+     * Selector for the vertex and edge lists of the devicegraph. Like
+     * boost::listS but the list nodes are allocated from a memory pool
+     * so that they are close to each other in memory and adding and
+     * removing vertices and edges does not go through the general
+     * purpose allocator.
+     */
+    struct pooled_listS {};
+
+#endif
+
+}
+
+
+#ifdef ENABLE_POOLED_GRAPH
+
+namespace boost
+{
+
+    template <typename ValueType>
+    struct container_gen<storage::pooled_listS, ValueType>
+    {
+	typedef std::list<ValueType, boost::fast_pool_allocator<ValueType>> type;
+    };
+
+
+    template <>
+    struct parallel_edge_traits<storage::pooled_listS>
+    {
+	typedef allow_parallel_edge_tag type;
+    };
+
+}
+
+#endif
+
+
+namespace storage
+{
+
     class Devicegraph::Impl : private boost::noncopyable
     {
 
@@ -62,8 +115,18 @@ namespace storage
 	// properties, see:
 	// http://www.boost.org/doc/libs/1_56_0/libs/graph/doc/bundles.html
 
-	typedef boost::adjacency_list<boost::listS, boost::listS, boost::bidirectionalS,
-				      std::shared_ptr<Device>, std::shared_ptr<Holder>> graph_t;
+	// With ENABLE_POOLED_GRAPH the lists are std::lists using a pool
+	// allocator, see pooled_listS. The iterator stability is the same.
+
+#ifdef ENABLE_POOLED_GRAPH
+	typedef pooled_listS list_selector_t;
+#else
+	typedef boost::listS list_selector_t;
+#endif
+
+	typedef boost::adjacency_list<list_selector_t, list_selector_t, boost::bidirectionalS,
+				      std::shared_ptr<Device>, std::shared_ptr<Holder>,
+				      boost::no_property, list_selector_t> graph_t;
 
 	typedef graph_t::vertex_descriptor vertex_descriptor;
 	typedef graph_t::edge_descriptor edge_descriptor;
@@ -131,6 +194,22 @@ namespace storage
 	vector<edge_descriptor> find_edges(sid_t source_sid, sid_t target_sid) const;
 	vector<edge_descriptor> find_edges(sid_pair_t sid_pair) const;
 
+	/**
+	 * Find the vertices of devices with the given name, sysfs path or
+	 * UUID using the secondary indices. The vertices are returned in the
+	 * order of vertices(). Callers must check the type of the devices.
+	 */
+	vector<vertex_descriptor> find_vertices_by_name(const string& name) const;
+	vector<vertex_descriptor> find_vertices_by_sysfs_path(const string& sysfs_path) const;
+	vector<vertex_descriptor> find_vertices_by_uuid(const string& uuid) const;
+
+	/**
+	 * Update the secondary indices (name, sysfs path, UUID) of the
+	 * vertex. Must be called whenever one of the indexed attributes of
+	 * the device changes, see Device::Impl::update_indices().
+	 */
+	void update_indices(vertex_descriptor vertex);
+
 	vertex_descriptor source(edge_descriptor edge) const { return boost::source(edge, graph); }
 	vertex_descriptor target(edge_descriptor edge) const { return boost::target(edge, graph); }
 
@@ -145,6 +224,12 @@ namespace storage
 
 	void clear();
 
+	/**
+	 * Reserve space in the indices for the given number of devices and
+	 * holders. Only useful on an empty devicegraph.
+	 */
+	void reserve(size_t num_devices, size_t num_holders);
+
 	void remove_vertex(vertex_descriptor vertex);
 	void remove_edge(edge_descriptor edge);
 
@@ -153,6 +238,7 @@ namespace storage
 
 	void load(Devicegraph* devicegraph, const string& filename, bool keep_sids);
 	void save(const string& filename) const;
+	void save_binary(const string& filename) const;
 
 	void print(std::ostream& out) const;
 
@@ -165,9 +251,144 @@ namespace storage
 	vertex_descriptor child(vertex_descriptor vertex, View view = View::CLASSIC) const;
 	vertex_descriptor parent(vertex_descriptor vertex, View view = View::CLASSIC) const;
 
-	// TODO use iterator base functions instead of vector based below
-	// boost::iterator_range<adjacency_iterator> children(vertex_descriptor vertex) const;
-	// boost::iterator_range<inv_adjacency_iterator> parents(vertex_descriptor vertex) const;
+	/**
+	 * Predicates for the out and in edges visible in a view. Same as
+	 * for filtered_graph_t an edge is visible if the holder and the
+	 * device at the other end are visible. The view is a template
+	 * parameter so that the check is resolved at compile time, e.g. for
+	 * View::ALL nothing needs to be checked.
+	 */
+	template <View view>
+	struct OutEdgeInView
+	{
+	    bool operator()(edge_descriptor edge) const
+	    {
+		if constexpr (view == View::ALL)
+		    return true;
+		else
+		    return is_in_view((*graph)[edge].get(), view) &&
+			is_in_view((*graph)[boost::target(edge, *graph)].get(), view);
+	    }
+
+	    const graph_t* graph;
+	};
+
+	template <View view>
+	struct InEdgeInView
+	{
+	    bool operator()(edge_descriptor edge) const
+	    {
+		if constexpr (view == View::ALL)
+		    return true;
+		else
+		    return is_in_view((*graph)[edge].get(), view) &&
+			is_in_view((*graph)[boost::source(edge, *graph)].get(), view);
+	    }
+
+	    const graph_t* graph;
+	};
+
+	struct EdgeSource
+	{
+	    vertex_descriptor operator()(edge_descriptor edge) const { return boost::source(edge, *graph); }
+
+	    const graph_t* graph;
+	};
+
+	struct EdgeTarget
+	{
+	    vertex_descriptor operator()(edge_descriptor edge) const { return boost::target(edge, *graph); }
+
+	    const graph_t* graph;
+	};
+
+	template <View view>
+	using view_out_edge_iterator = boost::filter_iterator<OutEdgeInView<view>, out_edge_iterator>;
+
+	template <View view>
+	using view_in_edge_iterator = boost::filter_iterator<InEdgeInView<view>, in_edge_iterator>;
+
+	template <View view>
+	using view_child_iterator = boost::transform_iterator<EdgeTarget, view_out_edge_iterator<view>>;
+
+	template <View view>
+	using view_parent_iterator = boost::transform_iterator<EdgeSource, view_in_edge_iterator<view>>;
+
+	/**
+	 * Lazy ranges of the out edges, in edges, children and parents of
+	 * the vertex in the view. Unlike the functions returning a vector
+	 * nothing is allocated. The ranges are invalidated when the edges of
+	 * the vertex are modified.
+	 */
+	template <View view = View::CLASSIC>
+	boost::iterator_range<view_out_edge_iterator<view>>
+	out_edges_range(vertex_descriptor vertex) const
+	{
+	    const OutEdgeInView<view> pred{ &graph };
+	    const pair<out_edge_iterator, out_edge_iterator> range = boost::out_edges(vertex, graph);
+
+	    return boost::make_iterator_range(view_out_edge_iterator<view>(pred, range.first, range.second),
+					      view_out_edge_iterator<view>(pred, range.second, range.second));
+	}
+
+	template <View view = View::CLASSIC>
+	boost::iterator_range<view_in_edge_iterator<view>>
+	in_edges_range(vertex_descriptor vertex) const
+	{
+	    const InEdgeInView<view> pred{ &graph };
+	    const pair<in_edge_iterator, in_edge_iterator> range = boost::in_edges(vertex, graph);
+
+	    return boost::make_iterator_range(view_in_edge_iterator<view>(pred, range.first, range.second),
+					      view_in_edge_iterator<view>(pred, range.second, range.second));
+	}
+
+	template <View view = View::CLASSIC>
+	boost::iterator_range<view_child_iterator<view>>
+	children_range(vertex_descriptor vertex) const
+	{
+	    const EdgeTarget func{ &graph };
+	    const boost::iterator_range<view_out_edge_iterator<view>> range = out_edges_range<view>(vertex);
+
+	    return boost::make_iterator_range(view_child_iterator<view>(range.begin(), func),
+					      view_child_iterator<view>(range.end(), func));
+	}
+
+	template <View view = View::CLASSIC>
+	boost::iterator_range<view_parent_iterator<view>>
+	parents_range(vertex_descriptor vertex) const
+	{
+	    const EdgeSource func{ &graph };
+	    const boost::iterator_range<view_in_edge_iterator<view>> range = in_edges_range<view>(vertex);
+
+	    return boost::make_iterator_range(view_parent_iterator<view>(range.begin(), func),
+					      view_parent_iterator<view>(range.end(), func));
+	}
+
+	/**
+	 * Calls func with std::integral_constant<View, view> so that the
+	 * ranges above can be used for a view only known at runtime.
+	 */
+	template <typename Func>
+	static decltype(auto)
+	with_view(View view, Func&& func)
+	{
+	    switch (view)
+	    {
+		case View::ALL:
+		    return func(std::integral_constant<View, View::ALL>());
+
+		case View::CLASSIC:
+		    return func(std::integral_constant<View, View::CLASSIC>());
+
+		case View::REMOVE:
+		    return func(std::integral_constant<View, View::REMOVE>());
+	    }
+
+	    ST_THROW(Exception("unknown view"));
+	}
+
+	static bool is_in_view(const Device* device, View view);
+	static bool is_in_view(const Holder* holder, View view);
 
 	vector<vertex_descriptor> children(vertex_descriptor vertex, View view = View::CLASSIC) const;
 	vector<vertex_descriptor> parents(vertex_descriptor vertex, View view = View::CLASSIC) const;
@@ -190,12 +411,8 @@ namespace storage
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
-	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device)
-		    ret.push_back(device);
-	    }
+	    for (vertex_descriptor vertex : vertices_of_type<Type>())
+		ret.push_back(dynamic_cast<Type*>(graph[vertex].get()));
 
 	    return ret;
 	}
@@ -207,10 +424,10 @@ namespace storage
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
+	    for (vertex_descriptor vertex : vertices_of_type<Type>())
 	    {
 		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device && pred(device))
+		if (pred(device))
 		    ret.push_back(device);
 	    }
 
@@ -218,9 +435,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<Type*>
-	filter_devices_of_type(const vector<vertex_descriptor>& vertices)
+	filter_devices_of_type(const Range& vertices)
 	{
 	    vector<Type*> ret;
 
@@ -235,9 +452,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<const Type*>
-	filter_devices_of_type(const vector<vertex_descriptor>& vertices) const
+	filter_devices_of_type(const Range& vertices) const
 	{
 	    vector<const Type*> ret;
 
@@ -252,9 +469,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<Type*>
-	filter_holders_of_type(const vector<edge_descriptor>& edges)
+	filter_holders_of_type(const Range& edges)
 	{
 	    vector<Type*> ret;
 
@@ -269,9 +486,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<const Type*>
-	filter_holders_of_type(const vector<edge_descriptor>& edges) const
+	filter_holders_of_type(const Range& edges) const
 	{
 	    vector<const Type*> ret;
 
@@ -286,18 +503,210 @@ namespace storage
 	}
 
 
+	/**
+	 * Children, parents, in holders and out holders of the vertex of
+	 * the given type in the view. Only the result is allocated.
+	 */
+	template <typename Type>
+	vector<Type*>
+	children_of_type(vertex_descriptor vertex, View view = View::CLASSIC)
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_devices_of_type<Type>(children_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<const Type*>
+	children_of_type(vertex_descriptor vertex, View view = View::CLASSIC) const
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_devices_of_type<Type>(children_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<Type*>
+	parents_of_type(vertex_descriptor vertex, View view = View::CLASSIC)
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_devices_of_type<Type>(parents_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<const Type*>
+	parents_of_type(vertex_descriptor vertex, View view = View::CLASSIC) const
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_devices_of_type<Type>(parents_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<Type*>
+	in_holders_of_type(vertex_descriptor vertex, View view = View::CLASSIC)
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_holders_of_type<Type>(in_edges_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<const Type*>
+	in_holders_of_type(vertex_descriptor vertex, View view = View::CLASSIC) const
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_holders_of_type<Type>(in_edges_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<Type*>
+	out_holders_of_type(vertex_descriptor vertex, View view = View::CLASSIC)
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_holders_of_type<Type>(out_edges_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	vector<const Type*>
+	out_holders_of_type(vertex_descriptor vertex, View view = View::CLASSIC) const
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		return filter_holders_of_type<Type>(out_edges_range<decltype(tag)::value>(vertex));
+	    });
+	}
+
+
+	template <typename Type>
+	size_t
+	num_children_of_type(vertex_descriptor vertex, View view = View::CLASSIC) const
+	{
+	    return with_view(view, [this, vertex](auto tag) {
+		size_t ret = 0;
+
+		for (vertex_descriptor child : children_range<decltype(tag)::value>(vertex))
+		{
+		    if (dynamic_cast<const Type*>(graph[child].get()))
+			++ret;
+		}
+
+		return ret;
+	    });
+	}
+
+
 	Storage* get_storage() { return storage; }
 	const Storage* get_storage() const { return storage; }
 
 	graph_t graph;		// TODO private?
 
+	/**
+	 * Rebuild the sid indices from the graph. Must be called after the
+	 * graph was modified without using the functions of this class,
+	 * e.g. by boost::copy_graph, or after sids were changed.
+	 */
+	void rebuild_indices();
+
+	/**
+	 * Gives the devices the sid of the corresponding device in
+	 * previous. Devices correspond if they have the same class, the
+	 * same displayname and corresponding parents. Devices without an
+	 * unambiguous counterpart keep their sid. Used to keep sids stable
+	 * when probing again.
+	 */
+	void adopt_sids(const Impl& previous);
+
     private:
 
 	vertex_filter_t make_vertex_filter(View view) const;
 	edge_filter_t make_edge_filter(View view) const;
 
+	/**
+	 * Vertices of all devices of the given type in the order of
+	 * vertices(). Uses the type index so only one dynamic_cast per
+	 * device class is needed to select the matching classes.
+	 */
+	template<typename Type>
+	vector<vertex_descriptor>
+	vertices_of_type() const
+	{
+	    vector<pair<size_t, vertex_descriptor>> tmp;
+
+	    for (const type_index_t::value_type& value : type_index)
+	    {
+		const std::map<size_t, vertex_descriptor>& positions = value.second;
+
+		if (!dynamic_cast<const Type*>(graph[positions.begin()->second].get()))
+		    continue;
+
+		tmp.insert(tmp.end(), positions.begin(), positions.end());
+	    }
+
+	    sort(tmp.begin(), tmp.end(), [](const pair<size_t, vertex_descriptor>& lhs,
+					    const pair<size_t, vertex_descriptor>& rhs) {
+		return lhs.first < rhs.first;
+	    });
+
+	    vector<vertex_descriptor> ret;
+	    ret.reserve(tmp.size());
+
+	    for (const pair<size_t, vertex_descriptor>& value : tmp)
+		ret.push_back(value.second);
+
+	    return ret;
+	}
+
+	vector<vertex_descriptor> find_vertices(const std::unordered_map<string, vector<vertex_descriptor>>& index,
+						const string& key) const;
+
+	void remove_from_indices(vertex_descriptor vertex);
+
 	Storage* storage;
 
+	void add_to_edge_index(edge_descriptor edge);
+	void remove_from_edge_index(edge_descriptor edge);
+
+	// Indices for fast lookup of vertices and edges by sids. Kept in sync
+	// by add_vertex, add_edge, remove_vertex, remove_edge and clear.
+
+	std::unordered_map<sid_t, vertex_descriptor> vertex_index;
+	std::unordered_map<sid_pair_t, vector<edge_descriptor>, boost::hash<sid_pair_t>> edge_index;
+
+	// Secondary indices for fast lookup of vertices by type, name, sysfs
+	// path and UUID. For each vertex the position in the order of
+	// vertices() and the keys it is indexed with are recorded.
+
+	struct IndexKeys
+	{
+	    size_t position;
+	    string classname;
+	    string name;
+	    string sysfs_path;
+	    string uuid;
+	};
+
+	typedef std::unordered_map<string, std::map<size_t, vertex_descriptor>> type_index_t;
+
+	size_t next_position = 0;
+
+	std::unordered_map<vertex_descriptor, IndexKeys> index_keys;
+
+	type_index_t type_index;
+
+	std::unordered_map<string, vector<vertex_descriptor>> name_index;
+	std::unordered_map<string, vector<vertex_descriptor>> sysfs_path_index;
+	std::unordered_map<string, vector<vertex_descriptor>> uuid_index;
+
     };
 
 }
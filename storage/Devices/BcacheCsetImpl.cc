@@ -177,7 +177,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<const BlkDevice>(devicegraph.parents(vertex));
+	return devicegraph.parents_of_type<const BlkDevice>(vertex);
     }
 
 
@@ -187,7 +187,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<const Bcache>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<const Bcache>(vertex);
     }
 
 
@@ -278,7 +278,7 @@ namespace storage
 
 	    if (regex_match(line, match, set_uuid_regex) && match.size() == 2)
 	    {
-		uuid = match[1];
+		set_uuid(match[1]);
 		y2mil("found set-uuid " << uuid);
 		break;
 	    }
@@ -359,7 +359,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	vector<const BlkDevice*> ret = devicegraph.filter_devices_of_type<const BlkDevice>(devicegraph.parents(vertex));
+	vector<const BlkDevice*> ret = devicegraph.parents_of_type<const BlkDevice>(vertex);
 
 	if(ret.empty())
 	    ST_THROW(DeviceNotFound("No backing device"));
@@ -376,7 +376,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	vector<const BcacheCset*> ret = devicegraph.filter_devices_of_type<const BcacheCset>(devicegraph.parents(vertex));
+	vector<const BcacheCset*> ret = devicegraph.parents_of_type<const BcacheCset>(vertex);
 
 	return !ret.empty();
     }
@@ -390,7 +390,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	vector<const BcacheCset*> ret = devicegraph.filter_devices_of_type<const BcacheCset>(devicegraph.parents(vertex));
+	vector<const BcacheCset*> ret = devicegraph.parents_of_type<const BcacheCset>(vertex);
 
 	return ret.front();
     }
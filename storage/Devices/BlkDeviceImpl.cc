@@ -21,9 +21,14 @@
  */
 
 
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <chrono>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
+#include "storage/Utils/AppUtil.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -100,7 +105,7 @@ namespace storage
 	    const CmdUdevadmInfo& cmd_udevadm_info = system_info.getCmdUdevadmInfo(name);
 
 	    sysfs_name = cmd_udevadm_info.get_name();
-	    sysfs_path = cmd_udevadm_info.get_path();
+	    set_sysfs_path(cmd_udevadm_info.get_path());
 
 	    const File& ro_file = get_sysfs_file(system_info, "ro");
 	    read_only = ro_file.get<bool>();
@@ -198,6 +203,8 @@ namespace storage
     BlkDevice::Impl::set_name(const string& name)
     {
 	Impl::name = name;
+
+	update_indices();
     }
 
 
@@ -321,7 +328,7 @@ namespace storage
 	if (!devicegraph->get_impl().is_system() && !devicegraph->get_impl().is_probed())
 	    ST_THROW(Exception("function called on wrong devicegraph"));
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
 	    if (blk_device)
@@ -335,7 +342,7 @@ namespace storage
 	{
 	    string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_sysfs_path(sysfs_path))
 	    {
 		const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
 		if (blk_device && blk_device->get_impl().active)
@@ -361,7 +368,7 @@ namespace storage
 	if (!devicegraph->get_impl().is_system() && !devicegraph->get_impl().is_probed())
 	    ST_THROW(Exception("function called on wrong devicegraph"));
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    BlkDevice* blk_device = dynamic_cast<BlkDevice*>(devicegraph->get_impl()[vertex]);
 	    if (blk_device)
@@ -375,7 +382,7 @@ namespace storage
 	{
 	    string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_sysfs_path(sysfs_path))
 	    {
 		BlkDevice* blk_device = dynamic_cast<BlkDevice*>(devicegraph->get_impl()[vertex]);
 		if (blk_device && blk_device->get_impl().active)
@@ -401,7 +408,7 @@ namespace storage
 	if (!devicegraph->get_impl().is_system() && !devicegraph->get_impl().is_probed())
 	    ST_THROW(Exception("function called on wrong devicegraph"));
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
 	    if (blk_device)
@@ -415,7 +422,7 @@ namespace storage
 	{
 	    string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_sysfs_path(sysfs_path))
 	    {
 		const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
 		if (blk_device && blk_device->get_impl().active)
@@ -886,6 +893,102 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	/**
+	 * Waits until all names exist (attach is true) or do not exist
+	 * (attach is false) using a single deadline for all names. Instead
+	 * of polling the directories of the names are watched with inotify
+	 * so that the function returns as soon as the nodes appear or
+	 * disappear. Returns the names that are not in the requested state.
+	 */
+	vector<string>
+	wait_for_names(const vector<string>& names, bool attach)
+	{
+	    const std::chrono::milliseconds timeout(5000);
+
+	    // Wake up regularly anyway since not every change is seen by the
+	    // watches, e.g. in sysfs or if inotify is not available.
+	    const std::chrono::milliseconds interval(100);
+
+	    const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM | IN_ATTRIB;
+
+	    auto pending = [&names, attach]() {
+		vector<string> ret;
+
+		for (const string& name : names)
+		{
+		    if ((access(name.c_str(), R_OK) == 0) != attach)
+			ret.push_back(name);
+		}
+
+		return ret;
+	    };
+
+	    vector<string> ret = pending();
+	    if (ret.empty())
+		return ret;
+
+	    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+
+	    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	    if (fd < 0)
+		y2war("inotify_init1 failed, errno:" << errno << " (" << stringerror(errno) << ")");
+
+	    while (true)
+	    {
+		// Adding the watches again is cheap and handles directories
+		// created in the meantime, e.g. /dev/md. If the directory
+		// does not exist yet watch /dev instead.
+
+		if (fd >= 0)
+		{
+		    for (const string& name : ret)
+		    {
+			if (inotify_add_watch(fd, dirname(name).c_str(), mask) < 0 &&
+			    boost::starts_with(name, DEV_DIR "/"))
+			    inotify_add_watch(fd, DEV_DIR, mask);
+		    }
+		}
+
+		ret = pending();
+		if (ret.empty())
+		    break;
+
+		std::chrono::milliseconds left = std::chrono::duration_cast<std::chrono::milliseconds>(
+		    deadline - std::chrono::steady_clock::now());
+		if (left.count() <= 0)
+		    break;
+
+		left = std::min(left, interval);
+
+		if (fd >= 0)
+		{
+		    struct pollfd pollfd = { fd, POLLIN, 0 };
+
+		    if (poll(&pollfd, 1, left.count()) > 0)
+		    {
+			char buffer[4096];
+			while (read(fd, buffer, sizeof(buffer)) > 0)
+			    ;
+		    }
+		}
+		else
+		{
+		    usleep(left.count() * 1000);
+		}
+	    }
+
+	    if (fd >= 0)
+		close(fd);
+
+	    return ret;
+	}
+
+    }
+
+
     void
     wait_for_devices(const vector<const BlkDevice*>& blk_devices)
     {
@@ -894,28 +997,18 @@ namespace storage
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	    return;
 
+	vector<string> names;
+
 	for (const BlkDevice* blk_device : blk_devices)
-	{
-	    string name = blk_device->get_name();
+	    names.push_back(blk_device->get_name());
 
-	    bool exists = access(name.c_str(), R_OK) == 0;
-	    y2mil("name:" << name << " exists:" << exists);
+	vector<string> missing = wait_for_names(names, true);
 
-	    if (!exists)
-	    {
-		for (int count = 0; count < 500; ++count)
-		{
-		    usleep(10000);
-		    exists = access(name.c_str(), R_OK) == 0;
-		    if (exists)
-			break;
-		}
-		y2mil("name:" << name << " exists:" << exists);
-	    }
+	for (const string& name : names)
+	    y2mil("name:" << name << " exists:" << !contains(missing, name));
 
-	    if (!exists)
-		ST_THROW(Exception("wait_for_devices failed " + name));
-	}
+	if (!missing.empty())
+	    ST_THROW(Exception("wait_for_devices failed " + boost::join(missing, " ")));
     }
 
 
@@ -941,32 +1034,13 @@ namespace storage
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	    return;
 
-	for (auto name : dev_names)
-	{
-	    bool exists = access(name.c_str(), R_OK) == 0;
+	vector<string> remaining = wait_for_names(dev_names, false);
 
-	    y2mil("name:" << name << " exists:" << exists);
+	for (const string& name : dev_names)
+	    y2mil("name:" << name << " exists:" << contains(remaining, name));
 
-	    if (exists)
-	    {
-		// Waits a max of 5 seconds
-		for (int count = 0; count < 500; ++count)
-		{
-		    if((count % 100) == 0)
-			y2mil("waiting for detach " << name);
-
-		    usleep(10000);
-		    exists = access(name.c_str(), R_OK) == 0;
-		    if (!exists)
-			break;
-		}
-
-		y2mil("name:" << name << " exists:" << exists);
-	    }
-
-	    if (exists)
-		ST_THROW(Exception("wait_for_detach_devices failed " + name));
-	}
+	if (!remaining.empty())
+	    ST_THROW(Exception("wait_for_detach_devices failed " + boost::join(remaining, " ")));
     }
 
 
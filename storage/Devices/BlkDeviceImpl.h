@@ -58,6 +58,9 @@ namespace storage
 
 	virtual string get_name_sort_key() const override { return get_name(); }
 
+	virtual string get_name_index_key() const override { return get_name(); }
+	virtual string get_sysfs_path_index_key() const override { return get_sysfs_path(); }
+
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	virtual bool is_usable_as_blk_device() const { return active; }
@@ -69,7 +72,7 @@ namespace storage
 	void set_sysfs_name(const string& sysfs_name) { Impl::sysfs_name = sysfs_name; }
 
 	const string& get_sysfs_path() const { return sysfs_path; }
-	void set_sysfs_path(const string& sysfs_path) { Impl::sysfs_path = sysfs_path; }
+	void set_sysfs_path(const string& sysfs_path) { Impl::sysfs_path = sysfs_path; update_indices(); }
 
 	const File& get_sysfs_file(SystemInfo::Impl& system_info, const char* filename) const;
 
@@ -237,13 +240,15 @@ namespace storage
 
 
     /**
-     * Run "udevadm settle" and check existence of all blk devices.
+     * Run "udevadm settle" and wait for the existence of all blk
+     * devices. Throws an exception if not all exist after 5 seconds.
      */
     void wait_for_devices(const vector<const BlkDevice*>& blk_devices);
 
 
     /**
-     * Run "udevadm settle" and check non existence of all blk devices.
+     * Run "udevadm settle" and wait for the non existence of all blk
+     * devices. Throws an exception if some still exist after 5 seconds.
      */
     void wait_for_detach_devices(const vector<const BlkDevice*>& blk_devices);
     void wait_for_detach_devices(const vector<string>& dev_names);
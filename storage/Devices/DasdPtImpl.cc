@@ -229,8 +229,6 @@ namespace storage
 	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " mklabel dasd";
 
 	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
-
-	SystemCmd(UDEVADM_BIN_SETTLE);
     }
 
 
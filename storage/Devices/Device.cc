@@ -217,7 +217,7 @@ namespace storage
 	Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_devices_of_type<Device>(devicegraph->get_impl().children(vertex, view));
+	return devicegraph->get_impl().children_of_type<Device>(vertex, view);
     }
 
 
@@ -227,7 +227,7 @@ namespace storage
 	const Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_devices_of_type<Device>(devicegraph->get_impl().children(vertex, view));
+	return devicegraph->get_impl().children_of_type<Device>(vertex, view);
     }
 
 
@@ -251,7 +251,7 @@ namespace storage
 	Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_devices_of_type<Device>(devicegraph->get_impl().parents(vertex, view));
+	return devicegraph->get_impl().parents_of_type<Device>(vertex, view);
     }
 
 
@@ -261,7 +261,7 @@ namespace storage
 	const Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_devices_of_type<Device>(devicegraph->get_impl().parents(vertex, view));
+	return devicegraph->get_impl().parents_of_type<Device>(vertex, view);
     }
 
 
@@ -385,7 +385,7 @@ namespace storage
 	Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_holders_of_type<Holder>(devicegraph->get_impl().in_edges(vertex));
+	return devicegraph->get_impl().in_holders_of_type<Holder>(vertex);
     }
 
 
@@ -395,7 +395,7 @@ namespace storage
 	const Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_holders_of_type<Holder>(devicegraph->get_impl().in_edges(vertex));
+	return devicegraph->get_impl().in_holders_of_type<Holder>(vertex);
     }
 
 
@@ -405,7 +405,7 @@ namespace storage
 	Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_holders_of_type<Holder>(devicegraph->get_impl().out_edges(vertex));
+	return devicegraph->get_impl().out_holders_of_type<Holder>(vertex);
     }
 
 
@@ -415,7 +415,7 @@ namespace storage
 	const Devicegraph* devicegraph = get_impl().get_devicegraph();
 	Devicegraph::Impl::vertex_descriptor vertex = get_impl().get_vertex();
 
-	return devicegraph->get_impl().filter_holders_of_type<Holder>(devicegraph->get_impl().out_edges(vertex));
+	return devicegraph->get_impl().out_holders_of_type<Holder>(vertex);
     }
 
 
@@ -176,6 +176,14 @@ namespace storage
     }
 
 
+    void
+    Device::Impl::update_indices()
+    {
+	if (devicegraph)
+	    devicegraph->get_impl().update_indices(vertex);
+    }
+
+
     Devicegraph*
     Device::Impl::get_devicegraph()
     {
@@ -101,6 +101,14 @@ namespace storage
 
 	virtual string get_name_sort_key() const { return ""; }
 
+	/**
+	 * Keys used for the name, sysfs path and UUID indices of the
+	 * devicegraph. Empty keys are not indexed.
+	 */
+	virtual string get_name_index_key() const { return ""; }
+	virtual string get_sysfs_path_index_key() const { return ""; }
+	virtual string get_uuid_index_key() const { return ""; }
+
 	virtual bool is_in_view(View view) const { return true; }
 
 	virtual void save(xmlNode* node) const = 0;
@@ -131,6 +139,13 @@ namespace storage
 
 	Devicegraph::Impl::vertex_descriptor get_vertex() const;
 
+	/**
+	 * Update the secondary indices of the devicegraph after one of the
+	 * indexed attributes was changed. Does nothing if the device is not
+	 * part of a devicegraph.
+	 */
+	void update_indices();
+
 	virtual Device* get_non_impl() { return devicegraph->get_impl()[vertex]; }
 	virtual const Device* get_non_impl() const { return devicegraph->get_impl()[vertex]; }
 
@@ -185,6 +200,13 @@ namespace storage
 	virtual void do_create_post_verify() const;
 	virtual uf_t do_create_used_features() const { return 0; }
 
+	/**
+	 * Whether do_create() only runs commands on the device and its parents
+	 * and can thus run in parallel to the creation of devices on other
+	 * disks.
+	 */
+	virtual bool is_create_parallelizable() const { return false; }
+
 	virtual Text do_delete_text(Tense tense) const;
 	virtual void do_delete() const;
 	virtual uf_t do_delete_used_features() const { return 0; }
@@ -258,7 +280,7 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.children(get_vertex(), view)).size();
+	    return devicegraph_impl.num_children_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -268,7 +290,7 @@ namespace storage
 
 	    Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.children(get_vertex(), view));
+	    return devicegraph_impl.children_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -278,7 +300,7 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.children(get_vertex(), view));
+	    return devicegraph_impl.children_of_type<Type>(get_vertex(), view);
 	}
 
 
@@ -328,7 +350,7 @@ namespace storage
 
 	    Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.parents(get_vertex(), view));
+	    return devicegraph_impl.parents_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -338,7 +360,7 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.parents(get_vertex(), view));
+	    return devicegraph_impl.parents_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -348,7 +370,7 @@ namespace storage
 
 	    Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_holders_of_type<Type>(devicegraph_impl.in_edges(get_vertex(), view));
+	    return devicegraph_impl.in_holders_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -358,7 +380,7 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_holders_of_type<Type>(devicegraph_impl.in_edges(get_vertex(), view));
+	    return devicegraph_impl.in_holders_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -368,7 +390,7 @@ namespace storage
 
 	    Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_holders_of_type<Type>(devicegraph_impl.out_edges(get_vertex(), view));
+	    return devicegraph_impl.out_holders_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -378,7 +400,7 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_holders_of_type<Type>(devicegraph_impl.out_edges(get_vertex(), view));
+	    return devicegraph_impl.out_holders_of_type<Type>(get_vertex(), view);
 	}
 
 	template<typename Type>
@@ -251,8 +251,6 @@ namespace storage
 	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " mklabel gpt";
 
 	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
-
-	SystemCmd(UDEVADM_BIN_SETTLE);
     }
 
 
@@ -101,6 +101,7 @@ namespace storage
 
 	virtual void do_create() override;
 	virtual uf_t do_create_used_features() const override { return UF_LUKS; }
+	virtual bool is_create_parallelizable() const override { return true; }
 
 	virtual void do_delete() const override;
 	virtual uf_t do_delete_used_features() const override { return UF_LUKS; }
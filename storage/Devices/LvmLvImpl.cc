@@ -668,7 +668,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	for (LvmLv* lvm_lv : devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex)))
+	for (LvmLv* lvm_lv : devicegraph.children_of_type<LvmLv>(vertex))
 	{
 	    if (lvm_lv->get_lv_name() == lv_name)
 		return lvm_lv;
@@ -684,7 +684,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<LvmLv>(vertex);
     }
 
 
@@ -694,7 +694,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<LvmLv>(vertex);
     }
 
 
@@ -95,7 +95,9 @@ namespace storage
 	LvType get_lv_type() const { return lv_type; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid) { Impl::uuid = uuid; update_indices(); }
+
+	virtual string get_uuid_index_key() const override { return get_uuid(); }
 
 	virtual void set_region(const Region& region) override;
 
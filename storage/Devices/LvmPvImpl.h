@@ -62,7 +62,9 @@ namespace storage
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid) { Impl::uuid = uuid; update_indices(); }
+
+	virtual string get_uuid_index_key() const override { return get_uuid(); }
 
 	bool has_blk_device() const;
 
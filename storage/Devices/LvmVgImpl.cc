@@ -377,7 +377,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<LvmPv>(devicegraph.parents(vertex));
+	return devicegraph.parents_of_type<LvmPv>(vertex);
     }
 
 
@@ -387,7 +387,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<const LvmPv>(devicegraph.parents(vertex));
+	return devicegraph.parents_of_type<const LvmPv>(vertex);
     }
 
 
@@ -422,7 +422,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	for (LvmLv* lvm_lv : devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex)))
+	for (LvmLv* lvm_lv : devicegraph.children_of_type<LvmLv>(vertex))
 	{
 	    if (lvm_lv->get_lv_name() == lv_name)
 		return lvm_lv;
@@ -438,7 +438,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<LvmLv>(vertex);
     }
 
 
@@ -448,7 +448,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<LvmLv>(vertex);
     }
 
 
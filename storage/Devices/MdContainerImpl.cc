@@ -66,7 +66,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<MdMember>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<MdMember>(vertex);
     }
 
 
@@ -76,7 +76,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<MdMember>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<MdMember>(vertex);
     }
 
 
@@ -708,7 +708,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<BlkDevice>(devicegraph.parents(vertex));
+	return devicegraph.parents_of_type<BlkDevice>(vertex);
     }
 
 
@@ -718,7 +718,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<const BlkDevice>(devicegraph.parents(vertex));
+	return devicegraph.parents_of_type<const BlkDevice>(vertex);
     }
 
 
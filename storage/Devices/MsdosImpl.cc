@@ -260,8 +260,7 @@ namespace storage
 
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 
-	return devicegraph.filter_devices_of_type<Partition>
-	    (devicegraph.children(partition->get_impl().get_vertex()));
+	return devicegraph.children_of_type<Partition>(partition->get_impl().get_vertex());
     }
 
 
@@ -273,8 +272,7 @@ namespace storage
 
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 
-	return devicegraph.filter_devices_of_type<const Partition>
-	    (devicegraph.children(partition->get_impl().get_vertex()));
+	return devicegraph.children_of_type<const Partition>(partition->get_impl().get_vertex());
     }
 
 
@@ -303,8 +301,6 @@ namespace storage
 	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " mklabel msdos";
 
 	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
-
-	SystemCmd(UDEVADM_BIN_SETTLE);
     }
 
 
@@ -311,24 +311,18 @@ namespace storage
 
 	actions.push_back(new Action::Create(get_sid(), false, nop));
 
-	if (default_id_for_type(type) != id)
-	{
-	    // For some partition ids it is fine to skip do_set_id() since
-	    // do_create() already sets the partition id correctly.
-
-	    static const vector<unsigned int> skip_ids = {
-		ID_LINUX, ID_SWAP, ID_DOS32, ID_NTFS, ID_WINDOWS_BASIC_DATA
-	    };
+	// If possible the partition id and the flags are set by the parted call
+	// creating the partition. The actions are still added (as nops) since they
+	// are displayed to the user.
 
-	    if (!contains(skip_ids, id))
-		actions.push_back(new Action::SetPartitionId(get_sid()));
-	}
+	if (is_set_id_needed_after_create())
+	    actions.push_back(new Action::SetPartitionId(get_sid(), is_set_coalesced()));
 
 	if (boot)
-	    actions.push_back(new Action::SetBoot(get_sid()));
+	    actions.push_back(new Action::SetBoot(get_sid(), is_set_coalesced()));
 
 	if (legacy_boot)
-	    actions.push_back(new Action::SetLegacyBoot(get_sid()));
+	    actions.push_back(new Action::SetLegacyBoot(get_sid(), is_set_coalesced()));
 
 	actiongraph.add_chain(actions);
     }
@@ -814,6 +808,22 @@ namespace storage
 	cmd_line += to_string(get_region().get_start() * factor) + " " +
 	    to_string(get_region().get_end() * factor + (factor - 1));
 
+	// Set the partition id and flags in the same parted call, see
+	// add_create_actions(). This avoids rereading and rewriting the
+	// partition table for each setting.
+
+	if (is_set_coalesced())
+	{
+	    if (is_set_id_needed_after_create())
+		cmd_line += " " + parted_set_id_commands();
+
+	    if (boot)
+		cmd_line += " " + parted_set_boot_commands();
+
+	    if (legacy_boot)
+		cmd_line += " " + parted_set_legacy_boot_commands();
+	}
+
 	SystemCmd(UDEVADM_BIN_SETTLE);
 
 	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
@@ -896,16 +906,26 @@ namespace storage
     Partition::Impl::do_set_id() const
     {
 	const Partitionable* partitionable = get_partitionable();
+
+	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " " +
+	    parted_set_id_commands();
+
+	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
+    }
+
+
+    string
+    Partition::Impl::parted_set_id_commands() const
+    {
 	const PartitionTable* partition_table = get_partition_table();
 
-	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " set " +
-	    to_string(get_number()) + " ";
+	string ret = "set " + to_string(get_number()) + " ";
 
 	if (is_msdos(partition_table))
 	{
 	    // Note: The type option is not available in upstream parted.
 
-	    cmd_line += "type " + to_string(get_id());
+	    ret += "type " + to_string(get_id());
 	}
 	else
 	{
@@ -913,52 +933,86 @@ namespace storage
 	    {
 		case ID_LINUX:
 		    // this is tricky but parted has no clearer way
-		    cmd_line += "lvm on set " + to_string(get_number()) + " lvm off";
+		    ret += "lvm on set " + to_string(get_number()) + " lvm off";
 		    break;
 
 		case ID_SWAP:
-		    cmd_line += "swap on";
+		    ret += "swap on";
 		    break;
 
 		case ID_LVM:
-		    cmd_line += "lvm on";
+		    ret += "lvm on";
 		    break;
 
 		case ID_RAID:
-		    cmd_line += "raid on";
+		    ret += "raid on";
 		    break;
 
 		case ID_IRST:
-		    cmd_line += "irst on";
+		    ret += "irst on";
 		    break;
 
 		case ID_ESP:
-		    cmd_line += "esp on";
+		    ret += "esp on";
 		    break;
 
 		case ID_BIOS_BOOT:
-		    cmd_line += "bios_grub on";
+		    ret += "bios_grub on";
 		    break;
 
 		case ID_PREP:
-		    cmd_line += "prep on";
+		    ret += "prep on";
 		    break;
 
 		case ID_WINDOWS_BASIC_DATA:
-		    cmd_line += "msftdata";
+		    ret += "msftdata";
 		    break;
 
 		case ID_MICROSOFT_RESERVED:
-		    cmd_line += "msftres";
+		    ret += "msftres";
 		    break;
 
 		case ID_DIAG:
-		    cmd_line += "diag";
+		    ret += "diag";
 		    break;
 	    }
 	}
 
-	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
+	return ret;
+    }
+
+
+    bool
+    Partition::Impl::is_set_id_needed_after_create() const
+    {
+	if (default_id_for_type(type) == id)
+	    return false;
+
+	// For some partition ids it is fine to skip do_set_id() since
+	// do_create() already sets the partition id correctly.
+
+	static const vector<unsigned int> skip_ids = {
+	    ID_LINUX, ID_SWAP, ID_DOS32, ID_NTFS, ID_WINDOWS_BASIC_DATA
+	};
+
+	return !contains(skip_ids, id);
+    }
+
+
+    bool
+    Partition::Impl::is_set_coalesced() const
+    {
+	if (is_implicit_pt(get_partition_table()))
+	    return false;
+
+	if (!is_set_id_needed_after_create() || is_msdos(get_partition_table()))
+	    return true;
+
+	// A flag without state must be the last command for parted.
+
+	const string commands = parted_set_id_commands();
+
+	return boost::ends_with(commands, " on") || boost::ends_with(commands, " off");
     }
 
 
@@ -993,13 +1047,20 @@ namespace storage
     {
 	const Partitionable* partitionable = get_partitionable();
 
-	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " set " +
-	    to_string(get_number()) + " boot " + (is_boot() ? "on" : "off");
+	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " " +
+	    parted_set_boot_commands();
 
 	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
     }
 
 
+    string
+    Partition::Impl::parted_set_boot_commands() const
+    {
+	return "set " + to_string(get_number()) + " boot " + (is_boot() ? "on" : "off");
+    }
+
+
     Text
     Partition::Impl::do_set_legacy_boot_text(Tense tense) const
     {
@@ -1031,13 +1092,20 @@ namespace storage
     {
 	const Partitionable* partitionable = get_partitionable();
 
-	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " set " +
-	    to_string(get_number()) + " legacy_boot " + (is_legacy_boot() ? "on" : "off");
+	string cmd_line = PARTED_BIN " --script " + quote(partitionable->get_name()) + " " +
+	    parted_set_legacy_boot_commands();
 
 	SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
     }
 
 
+    string
+    Partition::Impl::parted_set_legacy_boot_commands() const
+    {
+	return "set " + to_string(get_number()) + " legacy_boot " + (is_legacy_boot() ? "on" : "off");
+    }
+
+
     Text
     Partition::Impl::do_delete_text(Tense tense) const
     {
@@ -162,6 +162,25 @@ namespace storage
 
 	unsigned long long parted_sector_adjustment_factor() const;
 
+	/**
+	 * Checks whether the partition id must be set by an extra parted set
+	 * command after the partition was created.
+	 */
+	bool is_set_id_needed_after_create() const;
+
+	/**
+	 * Checks whether setting the partition id and flags is done by the
+	 * parted call in do_create() instead of by separate actions. Not
+	 * possible for implicit partitions (which are not created) and for
+	 * flags without an explicit state since parted would take the next
+	 * command as the state.
+	 */
+	bool is_set_coalesced() const;
+
+	string parted_set_id_commands() const;
+	string parted_set_boot_commands() const;
+	string parted_set_legacy_boot_commands() const;
+
     };
 
 
@@ -172,7 +191,7 @@ namespace storage
 	{
 	public:
 
-	    SetPartitionId(sid_t sid) : Modify(sid) {}
+	    SetPartitionId(sid_t sid, bool nop = false) : Modify(sid, false, nop) {}
 
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data, const CommitOptions& commit_options) const override;
@@ -184,7 +203,7 @@ namespace storage
 	{
 	public:
 
-	    SetBoot(sid_t sid) : Modify(sid) {}
+	    SetBoot(sid_t sid, bool nop = false) : Modify(sid, false, nop) {}
 
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data, const CommitOptions& commit_options) const override;
@@ -196,7 +215,7 @@ namespace storage
 	{
 	public:
 
-	    SetLegacyBoot(sid_t sid) : Modify(sid) {}
+	    SetLegacyBoot(sid_t sid, bool nop = false) : Modify(sid, false, nop) {}
 
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data, const CommitOptions& commit_options) const override;
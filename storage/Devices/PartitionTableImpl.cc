@@ -220,7 +220,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<Partition>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<Partition>(vertex);
     }
 
 
@@ -230,7 +230,7 @@ namespace storage
 	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	return devicegraph.filter_devices_of_type<Partition>(devicegraph.children(vertex));
+	return devicegraph.children_of_type<Partition>(vertex);
     }
 
 
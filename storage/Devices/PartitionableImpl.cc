@@ -144,14 +144,24 @@ namespace storage
     }
 
 
-    void
-    Partitionable::Impl::probe_pass_1c(Prober& prober)
+    bool
+    Partitionable::Impl::is_probe_pass_1c_needed() const
     {
 	if (has_children() || !is_active() || get_size() == 0)
-	    return;
+	    return false;
 
 	// do not run parted on host-managed zoned disks
 	if (!is_usable_as_partitionable())
+	    return false;
+
+	return true;
+    }
+
+
+    void
+    Partitionable::Impl::probe_pass_1c(Prober& prober)
+    {
+	if (!is_probe_pass_1c_needed())
 	    return;
 
 	try
@@ -126,6 +126,13 @@ namespace storage
     }
 
 
+    bool
+    support_probe_cache()
+    {
+	return read_env_var("LIBSTORAGE_PROBE_CACHE", false);
+    }
+
+
     bool
     developer_mode()
     {
@@ -93,6 +93,11 @@ namespace storage
      */
     bool support_btrfs_qgroups();
 
+    /**
+     * Switch to enable the probe cache, see ProbeCache.
+     */
+    bool support_probe_cache();
+
     /**
      * Switch to enable developer mode. What this mode exactly does is surely undefined.
      */
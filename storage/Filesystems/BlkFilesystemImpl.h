@@ -135,6 +135,7 @@ namespace storage
 	virtual const BlkFilesystem* get_non_impl() const override { return to_blk_filesystem(Device::Impl::get_non_impl()); }
 
 	virtual Text do_create_text(Tense tense) const override;
+	virtual bool is_create_parallelizable() const override { return true; }
 
 	virtual Text do_set_label_text(Tense tense) const;
 	virtual void do_set_label() const;
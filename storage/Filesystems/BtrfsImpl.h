@@ -160,6 +160,7 @@ namespace storage
 	virtual const Btrfs* get_non_impl() const override { return to_btrfs(Device::Impl::get_non_impl()); }
 
 	virtual void do_create() override;
+	virtual bool is_create_parallelizable() const override { return !configure_snapper; }
 
 	virtual void do_resize(const CommitData& commit_data, const Action::Resize* action) const override;
 
@@ -39,7 +39,7 @@ namespace storage
     Type*
     find_by_name(Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
 	    if (device && device->get_impl().get_name() == name)
@@ -54,7 +54,7 @@ namespace storage
     const Type*
     find_by_name(const Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
 	    if (device && device->get_impl().get_name() == name)
@@ -69,7 +69,7 @@ namespace storage
     Type*
     find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
 	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
 	    if (device && device->get_impl().get_uuid() == uuid)
@@ -84,7 +84,7 @@ namespace storage
     const Type*
     find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
 	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
 	    if (device && device->get_impl().get_uuid() == uuid)
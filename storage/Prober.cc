@@ -206,6 +206,8 @@ namespace storage
 	    handle(exception, _("Probing failed"), 0);
 	}
 
+	prefetch_pass_1a();
+
 	// Pass 1a
 
 	y2mil("prober pass 1a");
@@ -356,6 +358,8 @@ namespace storage
 
 	y2mil("prober pass 1c");
 
+	prefetch_pass_1c();
+
 	// TRANSLATORS: progress message
 	message_callback(probe_callbacks, _("Probing partitions"));
 
@@ -542,6 +546,84 @@ namespace storage
     }
 
 
+    void
+    Prober::prefetch_pass_1a()
+    {
+	typedef SystemInfo::Impl::prefetch_function_t prefetch_function_t;
+
+	vector<prefetch_function_t> prefetch_functions = {
+	    [](SystemInfo::Impl& system_info) { system_info.getBlkid(); },
+	    [](SystemInfo::Impl& system_info) { system_info.getCmdMultipath(); },
+	    [](SystemInfo::Impl& system_info) { system_info.getCmdDmraid(); },
+	    [](SystemInfo::Impl& system_info) { system_info.getCmdDmsetupTable(); }
+	};
+
+	if (!sys_block_entries.disks.empty())
+	    prefetch_functions.push_back([](SystemInfo::Impl& system_info) { system_info.getLsscsi(); });
+
+	system_info.prefetch(prefetch_functions);
+
+	// The next commands are only needed depending on the output of
+	// blkid.
+
+	prefetch_functions.clear();
+
+	try
+	{
+	    const Blkid& blkid = system_info.getBlkid();
+
+	    if (blkid.any_md())
+	    {
+		for (const string& short_name : sys_block_entries.mds)
+		{
+		    string name = DEV_DIR "/" + short_name;
+		    prefetch_functions.push_back([name](SystemInfo::Impl& system_info) {
+			system_info.getMdadmDetail(name);
+		    });
+		}
+	    }
+
+	    if (blkid.any_lvm())
+	    {
+		prefetch_functions.push_back([](SystemInfo::Impl& system_info) { system_info.getCmdPvs(); });
+		prefetch_functions.push_back([](SystemInfo::Impl& system_info) { system_info.getCmdVgs(); });
+		prefetch_functions.push_back([](SystemInfo::Impl& system_info) { system_info.getCmdLvs(); });
+	    }
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	}
+
+	system_info.prefetch(prefetch_functions);
+    }
+
+
+    void
+    Prober::prefetch_pass_1c()
+    {
+	vector<SystemInfo::Impl::prefetch_function_t> prefetch_functions;
+
+	for (Devicegraph::Impl::vertex_descriptor vertex : system->get_impl().vertices())
+	{
+	    const Device* device = system->get_impl()[vertex];
+	    if (is_partitionable(device))
+	    {
+		const Partitionable* partitionable = to_partitionable(device);
+		if (partitionable->get_impl().is_probe_pass_1c_needed())
+		{
+		    string name = partitionable->get_name();
+		    prefetch_functions.push_back([name](SystemInfo::Impl& system_info) {
+			system_info.getParted(name);
+		    });
+		}
+	    }
+	}
+
+	system_info.prefetch(prefetch_functions);
+    }
+
+
     void
     Prober::handle(const Exception& exception, const Text& message, uint64_t used_features) const
     {
@@ -131,6 +131,17 @@ namespace storage
 	 */
 	void flush_pending_holders();
 
+	/**
+	 * Runs the commands known to be needed in pass 1a in parallel, see
+	 * SystemInfo::Impl::prefetch().
+	 */
+	void prefetch_pass_1a();
+
+	/**
+	 * Runs parted for the partitionables probed in pass 1c in parallel.
+	 */
+	void prefetch_pass_1c();
+
     };
 
 }
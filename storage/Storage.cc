@@ -242,6 +242,13 @@ namespace storage
     }
 
 
+    vector<const Actiongraph*>
+    Storage::calculate_actiongraphs(const vector<Devicegraph*>& candidates)
+    {
+	return get_impl().calculate_actiongraphs(candidates);
+    }
+
+
     void
     Storage::activate(const ActivateCallbacks* activate_callbacks) const
     {
@@ -263,6 +270,13 @@ namespace storage
     }
 
 
+    ProbeChanges
+    Storage::reprobe(const ProbeCallbacks* probe_callbacks)
+    {
+	return get_impl().reprobe(probe_callbacks);
+    }
+
+
     void
     Storage::commit(const CommitCallbacks* commit_callbacks)
     {
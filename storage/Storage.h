@@ -185,6 +185,19 @@ namespace storage
     };
 
 
+    /**
+     * Changes found by Storage::reprobe() compared to the previous probed
+     * devicegraph. The sids of created devices are from the new probed
+     * devicegraph, of deleted devices from the previous one.
+     */
+    struct ProbeChanges
+    {
+	std::vector<sid_t> created;
+	std::vector<sid_t> deleted;
+	std::vector<sid_t> modified;
+    };
+
+
     class ProbeCallbacks : public Callbacks
     {
     public:
@@ -411,6 +424,27 @@ namespace storage
 	 */
 	const Actiongraph* calculate_actiongraph();
 
+	/**
+	 * Calculate the actiongraphs, including the compound actions, to get
+	 * from the system devicegraph to each of the candidate
+	 * devicegraphs. The actiongraphs are calculated concurrently. The
+	 * system devicegraph is only read.
+	 *
+	 * The candidates must be distinct devicegraphs of this storage
+	 * object other than the system devicegraph. No devicegraph of this
+	 * storage object must be modified during the call.
+	 *
+	 * The actiongraphs are owned by the storage object and are valid
+	 * until the next call of this function or until the system or the
+	 * candidate devicegraphs are modified. They cannot be committed.
+	 *
+	 * If the calculation fails for any candidate the exception of the
+	 * first such candidate is thrown.
+	 *
+	 * @throw Exception
+	 */
+	std::vector<const Actiongraph*> calculate_actiongraphs(const std::vector<Devicegraph*>& candidates);
+
 	/**
 	 * Activate devices like multipath, DM and MD RAID, LVM and LUKS. It
 	 * is not required to have probed the system to call this function. On
@@ -455,6 +489,20 @@ namespace storage
 	 */
 	void probe(const ProbeCallbacks* probe_callbacks = nullptr);
 
+	/**
+	 * Probe the system again like probe(). Devices that are found again
+	 * keep their sid, so references to them by sid, e.g. in pools,
+	 * stay valid. Devices correspond if they have the same type, name
+	 * and parents. Returns the devices that were created, deleted or
+	 * modified compared to the previous probed devicegraph.
+	 *
+	 * If probe() was not called before all devices are reported as
+	 * created.
+	 *
+	 * @throw Aborted, Exception
+	 */
+	ProbeChanges reprobe(const ProbeCallbacks* probe_callbacks = nullptr);
+
 	/**
 	 * The actiongraph must be valid.
 	 *
@@ -22,9 +22,17 @@
 
 
 #include "config.h"
+
+#include <thread>
+
 #include "storage/Utils/AppUtil.h"
+#include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/ProbeCache.h"
+#include "storage/Utils/Remote.h"
+#include "storage/Utils/StorageDefines.h"
 #include "storage/StorageImpl.h"
+#include "storage/DevicegraphImpl.h"
 #include "storage/Devices/DiskImpl.h"
 #include "storage/Devices/DasdImpl.h"
 #include "storage/Devices/MultipathImpl.h"
@@ -34,7 +42,7 @@
 #include "storage/Devices/LuksImpl.h"
 #include "storage/Pool.h"
 #include "storage/SystemInfo/SystemInfoImpl.h"
-#include "storage/Actiongraph.h"
+#include "storage/ActiongraphImpl.h"
 #include "storage/Prober.h"
 #include "storage/EnvironmentImpl.h"
 #include "storage/Utils/Format.h"
@@ -44,7 +52,16 @@
 namespace storage
 {
 
-    sid_t Storage::Impl::global_sid = initial_global_sid;
+    std::atomic<sid_t> Storage::Impl::global_sid(initial_global_sid);
+
+
+    void
+    Storage::Impl::raise_global_sid(sid_t sid)
+    {
+	sid_t tmp = global_sid;
+	while (tmp < sid + 1 && !global_sid.compare_exchange_weak(tmp, sid + 1))
+	    ;
+    }
 
 
     Storage::Impl::Impl(Storage& storage, const Environment& environment)
@@ -158,6 +175,54 @@ namespace storage
 
     void
     Storage::Impl::probe(const ProbeCallbacks* probe_callbacks)
+    {
+	probe(probe_callbacks, nullptr);
+    }
+
+
+    ProbeChanges
+    Storage::Impl::reprobe(const ProbeCallbacks* probe_callbacks)
+    {
+	Devicegraph previous(&storage);
+
+	if (exist_devicegraph("probed"))
+	    get_probed()->copy(previous);
+
+	probe(probe_callbacks, &previous);
+
+	const Devicegraph::Impl& lhs = previous.get_impl();
+	const Devicegraph::Impl& rhs = get_probed()->get_impl();
+
+	ProbeChanges probe_changes;
+
+	for (Devicegraph::Impl::vertex_descriptor vertex : lhs.vertices())
+	{
+	    sid_t sid = lhs[vertex]->get_sid();
+
+	    if (!rhs.device_exists(sid))
+		probe_changes.deleted.push_back(sid);
+	}
+
+	for (Devicegraph::Impl::vertex_descriptor vertex : rhs.vertices())
+	{
+	    const Device* device = rhs[vertex];
+	    sid_t sid = device->get_sid();
+
+	    if (!lhs.device_exists(sid))
+		probe_changes.created.push_back(sid);
+	    else if (!(device->get_impl() == lhs[lhs.find_vertex(sid)]->get_impl()))
+		probe_changes.modified.push_back(sid);
+	}
+
+	y2mil("reprobe created:" << probe_changes.created.size() << " deleted:" <<
+	      probe_changes.deleted.size() << " modified:" << probe_changes.modified.size());
+
+	return probe_changes;
+    }
+
+
+    void
+    Storage::Impl::probe(const ProbeCallbacks* probe_callbacks, const Devicegraph* previous)
     {
 	y2mil("probe begin");
 
@@ -211,6 +276,9 @@ namespace storage
 
 	y2mil("probe end");
 
+	if (previous)
+	    probed->get_impl().adopt_sids(previous->get_impl());
+
 	y2mil("probed devicegraph begin");
 	y2mil(*probed);
 	y2mil("probed devicegraph end");
@@ -224,10 +292,32 @@ namespace storage
     Storage::Impl::probe_helper(const ProbeCallbacks* probe_callbacks, Devicegraph* probed)
     {
 	SystemInfo::Impl system_info;
+	system_info.set_use_udevadm_export_db(true);
+
+	// The probe cache is only used when probing the real system.
+
+	const bool probe_cache = support_probe_cache() && Mockup::get_mode() == Mockup::Mode::NONE &&
+	    !get_remote_callbacks();
+
+	if (probe_cache)
+	    ProbeCache::activate(PROBE_CACHE_FILE);
 
-	arch = system_info.getArch();
+	try
+	{
+	    arch = system_info.getArch();
 
-	Prober prober(probe_callbacks, probed, system_info);
+	    Prober prober(probe_callbacks, probed, system_info);
+	}
+	catch (...)
+	{
+	    if (probe_cache)
+		ProbeCache::deactivate();
+
+	    throw;
+	}
+
+	if (probe_cache)
+	    ProbeCache::deactivate();
     }
 
 
@@ -458,6 +548,110 @@ namespace storage
     }
 
 
+    vector<const Actiongraph*>
+    Storage::Impl::calculate_actiongraphs(const vector<Devicegraph*>& candidates)
+    {
+	Devicegraph* system = get_system();
+
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+	    ST_CHECK_PTR(candidates[i]);
+
+	    if (candidates[i]->get_storage() != &storage)
+		ST_THROW(Exception("devicegraph belongs to wrong storage object"));
+
+	    // Generating the actiongraph modifies the candidate (see
+	    // Actiongraph::Impl::set_gpt_undersized()).
+
+	    if (candidates[i] == system)
+		ST_THROW(Exception("system devicegraph used as candidate"));
+
+	    if (find(candidates.begin(), candidates.begin() + i, candidates[i]) != candidates.begin() + i)
+		ST_THROW(Exception("candidate devicegraph used twice"));
+	}
+
+	candidate_actiongraphs.clear();	// free old actiongraphs before generating new to avoid memory peak
+
+	// Checking all devicegraphs is done once here instead of for each
+	// candidate.
+
+	CheckCallbacksLogger check_callbacks_logger;
+
+	check(&check_callbacks_logger);
+
+	const unsigned int max_threads = 8;
+
+	unsigned int num_threads = min(max_threads, max(thread::hardware_concurrency(), 2U));
+	num_threads = min<unsigned int>(num_threads, candidates.size());
+
+	y2mil("calculate " << candidates.size() << " actiongraphs with " << num_threads << " threads");
+
+	// Every candidate gets its own log buffer so that the log is
+	// written in the order of the candidates.
+
+	vector<std::unique_ptr<const Actiongraph>> actiongraphs(candidates.size());
+	vector<std::exception_ptr> exceptions(candidates.size());
+	vector<LogBuffer> log_buffers(candidates.size());
+
+	atomic<size_t> next(0);
+
+	auto worker = [this, system, &candidates, &actiongraphs, &exceptions, &log_buffers, &next]() {
+	    for (size_t i = next++; i < candidates.size(); i = next++)
+	    {
+		LogBuffer::Install install(log_buffers[i]);
+
+		try
+		{
+		    Actiongraph* tmp = new Actiongraph(new Actiongraph::Impl(storage, system, candidates[i],
+									     false));
+		    actiongraphs[i].reset(tmp);
+		    tmp->generate_compound_actions();
+		}
+		catch (const Exception& exception)
+		{
+		    ST_CAUGHT(exception);
+
+		    exceptions[i] = std::current_exception();
+		}
+		catch (...)
+		{
+		    exceptions[i] = std::current_exception();
+		}
+	    }
+	};
+
+	vector<thread> threads;
+	threads.reserve(num_threads);
+
+	for (unsigned int i = 0; i < num_threads; ++i)
+	    threads.emplace_back(worker);
+
+	for (thread& worker_thread : threads)
+	    worker_thread.join();
+
+	for (LogBuffer& log_buffer : log_buffers)
+	    log_buffer.write();
+
+	for (const std::exception_ptr& exception : exceptions)
+	{
+	    if (exception)
+		std::rethrow_exception(exception);
+	}
+
+	vector<const Actiongraph*> ret;
+
+	for (std::unique_ptr<const Actiongraph>& actiongraph : actiongraphs)
+	{
+	    ret.push_back(actiongraph.get());
+	    candidate_actiongraphs.push_back(std::move(actiongraph));
+	}
+
+	y2mil("calculate actiongraphs done");
+
+	return ret;
+    }
+
+
     void
     Storage::Impl::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks)
     {
@@ -26,6 +26,7 @@
 
 
 #include <map>
+#include <atomic>
 
 #include "storage/Utils/FileUtils.h"
 #include "storage/Utils/LockImpl.h"
@@ -103,12 +104,16 @@ namespace storage
 
 	const Actiongraph* calculate_actiongraph();
 
+	vector<const Actiongraph*> calculate_actiongraphs(const vector<Devicegraph*>& candidates);
+
 	void activate(const ActivateCallbacks* activate_callbacks) const;
 
 	DeactivateStatus deactivate() const;
 
 	void probe(const ProbeCallbacks* probe_callbacks);
 
+	ProbeChanges reprobe(const ProbeCallbacks* probe_callbacks);
+
 	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks);
 
 	void generate_pools(const Devicegraph* devicegraph);
@@ -135,7 +140,7 @@ namespace storage
 	/**
 	 * Raises the global sid to avoid potential conflicts with sid.
 	 */
-	static void raise_global_sid(sid_t sid) { global_sid = max(global_sid, sid + 1); }
+	static void raise_global_sid(sid_t sid);
 
 	/**
 	 * Resets the global sid. Only for testsuites.
@@ -149,7 +154,13 @@ namespace storage
 
 	static const sid_t initial_global_sid = 42;	// just a random number ;)
 
-	static sid_t global_sid;
+	static std::atomic<sid_t> global_sid;
+
+	/**
+	 * Probes and replaces the probed, system and staging devicegraphs.
+	 * If previous is not null the devices adopt the sids from it.
+	 */
+	void probe(const ProbeCallbacks* probe_callbacks, const Devicegraph* previous);
 
 	void probe_helper(const ProbeCallbacks* probe_callbacks, Devicegraph* system);
 
@@ -173,6 +184,11 @@ namespace storage
 
 	std::unique_ptr<const Actiongraph> actiongraph;
 
+	/**
+	 * Actiongraphs calculated by calculate_actiongraphs().
+	 */
+	vector<std::unique_ptr<const Actiongraph>> candidate_actiongraphs;
+
 	TmpDir tmp_dir;
 
     };
@@ -26,6 +26,8 @@
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/Format.h"
+#include "storage/Utils/AppUtil.h"
 #include "storage/SystemInfo/CmdStat.h"
 
 
@@ -37,15 +39,53 @@ namespace storage
     CmdStat::CmdStat(const string& path)
 	: path(path), mode(0)
     {
-	SystemCmd cmd(STAT_BIN " --format '%f' " + quote(path));
+	// For mockup playback and remote callbacks the output of 'stat' is
+	// used. Otherwise lstat is called directly (like 'stat' without
+	// '--dereference'). During mockup recording the result is saved as
+	// if 'stat' was run.
 
-	if (cmd.retcode() == 0 && cmd.stdout().size() >= 1)
-	    parse(cmd.stdout());
+	const string cmd_line = STAT_BIN " --format '%f' " + quote(path);
+
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	{
+	    SystemCmd cmd(cmd_line);
+
+	    if (cmd.retcode() == 0 && cmd.stdout().size() >= 1)
+		parse(cmd.stdout());
+	}
+	else
+	{
+	    stat_native(cmd_line);
+	}
 
 	y2mil(*this);
     }
 
 
+    void
+    CmdStat::stat_native(const string& cmd_line)
+    {
+	struct stat buf;
+
+	if (lstat(path.c_str(), &buf) != 0)
+	{
+	    string error = sformat("lstat for '%s' failed, %s", path, stringerror(errno));
+
+	    y2mil(error);
+
+	    if (Mockup::get_mode() == Mockup::Mode::RECORD)
+		Mockup::set_command(cmd_line, Mockup::Command({}, vector<string>({ error }), 1));
+
+	    return;
+	}
+
+	mode = buf.st_mode;
+
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	    Mockup::set_command(cmd_line, Mockup::Command(vector<string>({ sformat("%x", mode) })));
+    }
+
+
     void
     CmdStat::parse(const vector<string>& lines)
     {
@@ -55,6 +55,8 @@ namespace storage
 
 	void parse(const vector<string>& lines);
 
+	void stat_native(const string& cmd_line);
+
 	string path;
 
 	mode_t mode;
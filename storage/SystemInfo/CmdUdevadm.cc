@@ -26,6 +26,7 @@
 
 #include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/CmdUdevadm.h"
@@ -41,8 +42,158 @@ namespace storage
     });
 
 
+    CmdUdevadmExportDb::CmdUdevadmExportDb()
+    {
+	const string cmd_line = UDEVADM_BIN " info --export-db";
+
+	// Older mockups do not include the udev database. In that case
+	// nothing is found and 'udevadm info' is run for every device.
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK && !Mockup::has_command(cmd_line))
+	{
+	    y2mil("no udev database in mockup");
+	    return;
+	}
+
+	// See comment in CmdUdevadmInfo::probe().
+	SystemCmd(UDEVADM_BIN_SETTLE);
+
+	SystemCmd cmd(cmd_line);
+	if (cmd.retcode() != 0)
+	{
+	    y2err("udevadm info --export-db failed");
+	    return;
+	}
+
+	parse(cmd.stdout());
+    }
+
+
+    void
+    CmdUdevadmExportDb::parse(const vector<string>& stdout)
+    {
+	// The entries are separated by empty lines. Only block devices are
+	// of interest. The lines have the same format as in the output of
+	// 'udevadm info'.
+
+	vector<string> lines;
+	bool block = false;
+
+	for (vector<string>::const_iterator it = stdout.begin(); ; ++it)
+	{
+	    if (it == stdout.end() || it->empty())
+	    {
+		if (block)
+		    devices.push_back(lines);
+
+		lines.clear();
+		block = false;
+
+		if (it == stdout.end())
+		    break;
+
+		continue;
+	    }
+
+	    if (*it == "E: SUBSYSTEM=block")
+		block = true;
+
+	    lines.push_back(*it);
+	}
+
+	build_index();
+
+	y2mil(*this);
+    }
+
+
+    void
+    CmdUdevadmExportDb::build_index()
+    {
+	// A udev link can be claimed by several devices, e.g. by-id links of
+	// multipath devices. Then it is unknown which device the link points
+	// to and the link is left out of the index.
+
+	map<string, vector<size_t>> tmp;
+
+	for (size_t i = 0; i < devices.size(); ++i)
+	{
+	    unsigned int major = 0;
+	    unsigned int minor = 0;
+
+	    for (const string& line : devices[i])
+	    {
+		if (boost::starts_with(line, "P: "))
+		    tmp["/sys" + line.substr(strlen("P: "))].push_back(i);
+
+		if (boost::starts_with(line, "N: "))
+		    tmp[DEV_DIR "/" + line.substr(strlen("N: "))].push_back(i);
+
+		if (boost::starts_with(line, "S: "))
+		    tmp[DEV_DIR "/" + line.substr(strlen("S: "))].push_back(i);
+
+		if (boost::starts_with(line, "E: MAJOR="))
+		    line.substr(strlen("E: MAJOR=")) >> major;
+
+		if (boost::starts_with(line, "E: MINOR="))
+		    line.substr(strlen("E: MINOR=")) >> minor;
+	    }
+
+	    if (major != 0)
+		tmp[DEV_DIR "/block/" + to_string(major) + ":" + to_string(minor)].push_back(i);
+	}
+
+	for (const map<string, vector<size_t>>::value_type& value : tmp)
+	{
+	    if (value.second.size() == 1)
+		index[value.first] = value.second.front();
+	    else
+		y2mil("ambiguous udev entry " << value.first);
+	}
+    }
+
+
+    const vector<string>*
+    CmdUdevadmExportDb::find(const string& file) const
+    {
+	map<string, size_t>::const_iterator it = index.find(file);
+	if (it == index.end())
+	    return nullptr;
+
+	return &devices[it->second];
+    }
+
+
+    std::ostream&
+    operator<<(std::ostream& s, const CmdUdevadmExportDb& cmd_udevadm_export_db)
+    {
+	s << "devices:" << cmd_udevadm_export_db.size() << " index-entries:"
+	  << cmd_udevadm_export_db.index.size() << '\n';
+
+	return s;
+    }
+
+
     CmdUdevadmInfo::CmdUdevadmInfo(const string& file)
 	: file(file)
+    {
+	probe();
+    }
+
+
+    CmdUdevadmInfo::CmdUdevadmInfo(const key_t& file, const CmdUdevadmExportDb* cmd_udevadm_export_db)
+	: file(file)
+    {
+	const vector<string>* lines = cmd_udevadm_export_db ? cmd_udevadm_export_db->find(file) : nullptr;
+
+	if (lines)
+	    parse(*lines);
+	else
+	    probe();
+    }
+
+
+    void
+    CmdUdevadmInfo::probe()
     {
 	// Without emptying the udev queue 'udevadm info' can display old data
 	// or even complain about unknown devices. Even during probing this
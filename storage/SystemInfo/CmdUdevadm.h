@@ -29,6 +29,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 #include "storage/Utils/Enum.h"
 
@@ -37,6 +38,43 @@ namespace storage
 {
     using std::string;
     using std::vector;
+    using std::map;
+
+
+    /**
+     * Reads the udev data of all block devices with a single 'udevadm info
+     * --export-db' after a single 'udevadm settle'. Avoids running
+     * 'udevadm settle' and 'udevadm info' for every device.
+     */
+    class CmdUdevadmExportDb
+    {
+
+    public:
+
+	CmdUdevadmExportDb();
+
+	/**
+	 * Returns the 'udevadm info' output for file or nullptr if file is
+	 * not known. file can be the device name, a udev link, the sysfs
+	 * path or /dev/block/<major>:<minor>.
+	 */
+	const vector<string>* find(const string& file) const;
+
+	size_t size() const { return devices.size(); }
+
+	friend std::ostream& operator<<(std::ostream& s, const CmdUdevadmExportDb& cmd_udevadm_export_db);
+
+    private:
+
+	void parse(const vector<string>& stdout);
+
+	void build_index();
+
+	vector<vector<string>> devices;
+
+	map<string, size_t> index;
+
+    };
 
 
     class CmdUdevadmInfo
@@ -44,10 +82,18 @@ namespace storage
 
     public:
 
+	typedef string key_t;
+
 	enum class DeviceType { UNKNOWN, DISK, PARTITION };
 
 	CmdUdevadmInfo(const string& file);
 
+	/**
+	 * Uses the data from cmd_udevadm_export_db if available for file and
+	 * otherwise runs 'udevadm info'.
+	 */
+	CmdUdevadmInfo(const key_t& file, const CmdUdevadmExportDb* cmd_udevadm_export_db);
+
 	const string& get_path() const { return path; }
 	const string& get_name() const { return name; }
 
@@ -66,6 +112,8 @@ namespace storage
 
     private:
 
+	void probe();
+
 	void parse(const vector<string>& stdout);
 
 	string file;
@@ -21,6 +21,7 @@
  */
 
 
+#include <dirent.h>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/LoggerImpl.h"
@@ -28,6 +29,8 @@
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/Format.h"
+#include "storage/Utils/AppUtil.h"
 #include "storage/SystemInfo/DevAndSys.h"
 
 
@@ -39,14 +42,62 @@ namespace storage
     Dir::Dir(const string& path)
 	: path(path)
     {
-	SystemCmd cmd(LS_BIN " -1 --sort=none " + quote(path), SystemCmd::DoThrow);
+	// For mockup playback and remote callbacks the output of 'ls' is
+	// used. Otherwise the directory is read directly which avoids
+	// starting a shell and 'ls' for every directory. During mockup
+	// recording the result is saved as if 'ls' was run.
 
-	parse(cmd.stdout());
+	const string cmd_line = LS_BIN " -1 --sort=none " + quote(path);
+
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	{
+	    SystemCmd cmd(cmd_line, SystemCmd::DoThrow);
+
+	    parse(cmd.stdout());
+	}
+	else
+	{
+	    read_native(cmd_line);
+	}
 
 	y2mil(*this);
     }
 
 
+    void
+    Dir::read_native(const string& cmd_line)
+    {
+	DIR* dir = opendir(path.c_str());
+	if (!dir)
+	{
+	    string error = sformat("opendir for '%s' failed, %s", path, stringerror(errno));
+
+	    if (Mockup::get_mode() == Mockup::Mode::RECORD)
+		Mockup::set_command(cmd_line, Mockup::Command({}, vector<string>({ error }), 2));
+
+	    ST_THROW(Exception(error));
+	}
+
+	vector<string> lines;
+
+	while (const struct dirent* dirent = readdir(dir))
+	{
+	    // like 'ls' without '--all' skip hidden entries
+	    if (dirent->d_name[0] == '.')
+		continue;
+
+	    lines.push_back(dirent->d_name);
+	}
+
+	closedir(dir);
+
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	    Mockup::set_command(cmd_line, Mockup::Command(lines, {}, 0));
+
+	parse(lines);
+    }
+
+
     void
     Dir::parse(const vector<string>& lines)
     {
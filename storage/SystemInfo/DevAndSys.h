@@ -63,6 +63,8 @@ namespace storage
 
 	void parse(const vector<string>& lines);
 
+	void read_native(const string& cmd_line);
+
 	string path;
 
 	vector<string> entries;
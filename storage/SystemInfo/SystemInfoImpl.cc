@@ -20,11 +20,20 @@
  */
 
 
+#include <atomic>
+#include <thread>
+
 #include "storage/SystemInfo/SystemInfoImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/Remote.h"
 
 
 namespace storage
 {
+    using namespace std;
+
 
     SystemInfo::Impl::Impl()
     {
@@ -37,4 +46,78 @@ namespace storage
 	y2deb("destructed SystemInfo::Impl");
     }
 
+
+    static void
+    call_prefetch_function(const SystemInfo::Impl::prefetch_function_t& prefetch_function,
+			   SystemInfo::Impl& system_info)
+    {
+	try
+	{
+	    prefetch_function(system_info);
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	}
+	catch (const std::exception& exception)
+	{
+	    y2err("prefetch failed, " << exception.what());
+	}
+    }
+
+
+    void
+    SystemInfo::Impl::prefetch(const vector<prefetch_function_t>& prefetch_functions)
+    {
+	// Mockup and remote callbacks are not thread-safe. Calling the
+	// functions in order also keeps the mockup recordings and the log
+	// deterministic.
+
+	if (Mockup::get_mode() != Mockup::Mode::NONE || get_remote_callbacks() ||
+	    prefetch_functions.size() <= 1)
+	{
+	    for (const prefetch_function_t& prefetch_function : prefetch_functions)
+		call_prefetch_function(prefetch_function, *this);
+
+	    return;
+	}
+
+	const unsigned int max_threads = 8;
+
+	unsigned int num_threads = min(max_threads, max(thread::hardware_concurrency(), 2U));
+	num_threads = min<unsigned int>(num_threads, prefetch_functions.size());
+
+	y2mil("prefetch " << prefetch_functions.size() << " functions with " << num_threads << " threads");
+
+	// Every function gets its own log buffer so that the log is written
+	// in the order of the functions.
+
+	vector<LogBuffer> log_buffers(prefetch_functions.size());
+
+	atomic<size_t> next(0);
+
+	auto worker = [this, &prefetch_functions, &log_buffers, &next]() {
+	    for (size_t i = next++; i < prefetch_functions.size(); i = next++)
+	    {
+		LogBuffer::Install install(log_buffers[i]);
+
+		call_prefetch_function(prefetch_functions[i], *this);
+	    }
+	};
+
+	vector<thread> threads;
+	threads.reserve(num_threads);
+
+	for (unsigned int i = 0; i < num_threads; ++i)
+	    threads.emplace_back(worker);
+
+	for (thread& worker_thread : threads)
+	    worker_thread.join();
+
+	for (LogBuffer& log_buffer : log_buffers)
+	    log_buffer.write();
+
+	y2mil("prefetch done");
+    }
+
 }
@@ -25,6 +25,9 @@
 #define STORAGE_SYSTEM_INFO_IMPL_H
 
 
+#include <mutex>
+#include <functional>
+
 #include "storage/EtcFstab.h"
 #include "storage/EtcCrypttab.h"
 #include "storage/EtcMdadm.h"
@@ -76,6 +79,19 @@ namespace storage
 	Impl();
 	~Impl();
 
+	typedef std::function<void(Impl&)> prefetch_function_t;
+
+	/**
+	 * Calls the functions in a bounded number of worker threads. The
+	 * functions should only call getters of this class so that the
+	 * results are cached for later calls. Exceptions are ignored since
+	 * they are also cached.
+	 *
+	 * For mockup playback and recording and with remote callbacks the
+	 * functions are called one after the other in the calling thread.
+	 */
+	void prefetch(const vector<prefetch_function_t>& prefetch_functions);
+
 	const EtcFstab& getEtcFstab() { return etc_fstab.get(); }
 	const EtcCrypttab& getEtcCrypttab() { return etc_crypttab.get(); }
 	const EtcMdadm& getEtcMdadm() { return etc_mdadm.get(); }
@@ -125,7 +141,19 @@ namespace storage
 	const CmdVgs& getCmdVgs() { return cmd_vgs.get(); }
 	const CmdLvs& getCmdLvs() { return cmd_lvs.get(); }
 
-	const CmdUdevadmInfo& getCmdUdevadmInfo(const string& file) { return cmd_udevadm_infos.get(file); }
+	/**
+	 * Read the udev data of all block devices at once with the first call
+	 * of getCmdUdevadmInfo() instead of running 'udevadm settle' and
+	 * 'udevadm info' for each device. Only useful if the udev data of
+	 * many devices is needed, e.g. during probing.
+	 */
+	void set_use_udevadm_export_db(bool use_udevadm_export_db)
+	    { Impl::use_udevadm_export_db = use_udevadm_export_db; }
+
+	const CmdUdevadmExportDb& getCmdUdevadmExportDb() { return cmd_udevadm_export_db.get(); }
+
+	const CmdUdevadmInfo& getCmdUdevadmInfo(const string& file)
+	    { return cmd_udevadm_infos.get(CmdUdevadmInfo::key_t(file), use_udevadm_export_db ? &getCmdUdevadmExportDb() : nullptr); }
 	const CmdDf& getCmdDf(const string& mount_point) { return cmd_dfs.get(mount_point); }
 
 	// The device is only used for the cache-key.
@@ -136,7 +164,8 @@ namespace storage
 
 	/* LazyObject, LazyObjects and LazyObjectsWithKey cache the object and
 	   a potential exception during object construction. HelperBase does
-	   the common part. */
+	   the common part. All are thread-safe so that objects can be
+	   constructed in worker threads, see prefetch(). */
 
 	template <class Object, typename... Args>
 	class HelperBase
@@ -145,6 +174,8 @@ namespace storage
 
 	    const Object& get(Args... args)
 	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		if (ep)
 		    std::rethrow_exception(ep);
 
@@ -166,6 +197,8 @@ namespace storage
 
 	private:
 
+	    std::mutex mutex;
+
 	    std::shared_ptr<Object> object;
 	    std::exception_ptr ep;
 
@@ -187,14 +220,19 @@ namespace storage
 
 	    const Object& get(const Arg& arg)
 	    {
-		typename map<Arg, Helper>::iterator pos = data.lower_bound(arg);
-		if (pos == data.end() || typename map<Arg, Helper>::key_compare()(arg, pos->first))
-		    pos = data.insert(pos, typename map<Arg, Helper>::value_type(arg, Helper()));
-		return pos->second.get(arg);
+		return helper(arg).get(arg);
 	    }
 
 	private:
 
+	    Helper& helper(const Arg& arg)
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+		return data.try_emplace(arg).first->second;
+	    }
+
+	    std::mutex mutex;
+
 	    map<Arg, Helper> data;
 
 	};
@@ -211,20 +249,25 @@ namespace storage
 
 	    bool includes(const Key& key) const
 	    {
-		typename map<Key, Helper>::const_iterator pos = data.lower_bound(key);
-		return pos != data.end() && !typename map<Key, Helper>::key_compare()(key, pos->first);
+		std::lock_guard<std::mutex> lock(mutex);
+		return data.find(key) != data.end();
 	    }
 
 	    const Object& get(const Key& key, Args... args)
 	    {
-		typename map<Key, Helper>::iterator pos = data.lower_bound(key);
-		if (pos == data.end() || typename map<Key, Helper>::key_compare()(key, pos->first))
-		    pos = data.insert(pos, typename map<Key, Helper>::value_type(key, Helper()));
-		return pos->second.get(key, args...);
+		return helper(key).get(key, args...);
 	    }
 
 	private:
 
+	    Helper& helper(const Key& key)
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+		return data.try_emplace(key).first->second;
+	    }
+
+	    mutable std::mutex mutex;
+
 	    map<Key, Helper> data;
 
 	};
@@ -263,7 +306,10 @@ namespace storage
 	LazyObject<CmdVgs> cmd_vgs;
 	LazyObject<CmdLvs> cmd_lvs;
 
-	LazyObjects<CmdUdevadmInfo> cmd_udevadm_infos;
+	bool use_udevadm_export_db = false;
+
+	LazyObject<CmdUdevadmExportDb> cmd_udevadm_export_db;
+	LazyObjectsWithKey<CmdUdevadmInfo, const CmdUdevadmExportDb*> cmd_udevadm_infos;
 	LazyObjects<CmdDf> cmd_dfs;
 
 	LazyObjectsWithKey<CmdLsattr, string, string> cmd_lsattr;
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "storage/Utils/BinaryFile.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/Format.h"
+
+
+namespace storage
+{
+
+    namespace
+    {
+
+	enum : unsigned char { CONTENT_EMPTY = 0, CONTENT_TEXT = 1, CONTENT_ELEMENTS = 2 };
+
+	// Protects against unbounded recursion on corrupt files.
+	const unsigned int max_depth = 32;
+
+    }
+
+
+    BinaryFileReader::BinaryFileReader(const string& filename, const char magic[8],
+				       unsigned int max_version)
+	: filename(filename), data(nullptr), size(0), pos(0), version(0), current(nullptr)
+    {
+	int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	    ST_THROW(Exception(sformat("failed to open '%s'", filename)));
+
+	struct stat buf;
+	if (fstat(fd, &buf) != 0 || buf.st_size < 12)
+	{
+	    ::close(fd);
+	    ST_THROW(Exception(sformat("failed to load binary file '%s'", filename)));
+	}
+
+	size = buf.st_size;
+
+	void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (p == MAP_FAILED)
+	    ST_THROW(Exception(sformat("failed to map '%s'", filename)));
+
+	data = (const unsigned char*) p;
+
+	if (memcmp(data, magic, 8) != 0)
+	{
+	    munmap((void*) data, size);
+	    ST_THROW(Exception(sformat("wrong magic in '%s'", filename)));
+	}
+
+	version = data[8] | data[9] << 8 | data[10] << 16 | (unsigned int)(data[11]) << 24;
+	pos = 12;
+
+	if (version == 0 || version > max_version)
+	{
+	    munmap((void*) data, size);
+	    ST_THROW(Exception(sformat("unsupported version %d of '%s'", version, filename)));
+	}
+    }
+
+
+    BinaryFileReader::~BinaryFileReader()
+    {
+	if (current)
+	    xmlFreeNode(current);
+
+	munmap((void*) data, size);
+    }
+
+
+    bool
+    BinaryFileReader::has_magic(const string& filename, const char magic[8])
+    {
+	std::ifstream fin(filename, std::ios::binary);
+
+	char buf[8];
+	if (!fin.read(buf, 8))
+	    return false;
+
+	return memcmp(buf, magic, 8) == 0;
+    }
+
+
+    bool
+    BinaryFileReader::next_record(char& type, const xmlNode*& node)
+    {
+	if (current)
+	{
+	    xmlFreeNode(current);
+	    current = nullptr;
+	}
+
+	if (pos == size)
+	    return false;
+
+	type = data[pos++];
+
+	current = ::xmlNewNode(NULL, (const xmlChar*) read_name().c_str());
+	read_content(current, 0);
+
+	node = current->children;
+
+	return true;
+    }
+
+
+    unsigned long long
+    BinaryFileReader::read_number()
+    {
+	unsigned long long value = 0;
+
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+	    if (pos == size)
+		ST_THROW(Exception(sformat("unexpected end of '%s'", filename)));
+
+	    unsigned char byte = data[pos++];
+	    value |= (unsigned long long)(byte & 0x7f) << shift;
+
+	    if (!(byte & 0x80))
+		return value;
+	}
+
+	ST_THROW(Exception(sformat("invalid number in '%s'", filename)));
+    }
+
+
+    string
+    BinaryFileReader::read_string()
+    {
+	unsigned long long length = read_number();
+	if (length > size - pos)
+	    ST_THROW(Exception(sformat("unexpected end of '%s'", filename)));
+
+	string value((const char*)(data + pos), length);
+	pos += length;
+
+	return value;
+    }
+
+
+    const string&
+    BinaryFileReader::read_name()
+    {
+	unsigned long long index = read_number();
+
+	if (index == names.size())
+	    names.push_back(read_string());
+	else if (index > names.size())
+	    ST_THROW(Exception(sformat("invalid name in '%s'", filename)));
+
+	return names[index];
+    }
+
+
+    void
+    BinaryFileReader::read_content(xmlNode* node, unsigned int depth)
+    {
+	if (pos == size)
+	    ST_THROW(Exception(sformat("unexpected end of '%s'", filename)));
+
+	switch (data[pos++])
+	{
+	    case CONTENT_EMPTY:
+		break;
+
+	    case CONTENT_TEXT: {
+		const string text = read_string();
+		xmlAddChild(node, xmlNewTextLen((const xmlChar*) text.c_str(), text.size()));
+	    } break;
+
+	    case CONTENT_ELEMENTS: {
+		if (depth == max_depth)
+		    ST_THROW(Exception(sformat("nesting too deep in '%s'", filename)));
+
+		for (unsigned long long n = read_number(); n > 0; --n)
+		{
+		    xmlNode* child = ::xmlNewChild(node, NULL, (const xmlChar*) read_name().c_str(), NULL);
+		    read_content(child, depth + 1);
+		}
+	    } break;
+
+	    default:
+		ST_THROW(Exception(sformat("invalid content in '%s'", filename)));
+	}
+    }
+
+
+    BinaryFileWriter::BinaryFileWriter(const string& filename, const char magic[8], unsigned int version)
+	: filename(filename), fout(filename, std::ios::binary)
+    {
+	if (!fout)
+	    ST_THROW(Exception(sformat("failed to write '%s'", filename)));
+
+	fout.write(magic, 8);
+
+	for (unsigned int i = 0; i < 4; ++i)
+	    fout.put((char)(version >> (8 * i)));
+    }
+
+
+    BinaryFileWriter::~BinaryFileWriter()
+    {
+    }
+
+
+    void
+    BinaryFileWriter::write_record(char type, xmlNode* node)
+    {
+	fout.put(type);
+
+	write_name((const char*) node->name);
+	write_content(node);
+
+	xmlFreeNode(node);
+    }
+
+
+    void
+    BinaryFileWriter::close()
+    {
+	fout.close();
+
+	if (!fout)
+	    ST_THROW(Exception(sformat("failed to write '%s'", filename)));
+    }
+
+
+    void
+    BinaryFileWriter::write_number(unsigned long long value)
+    {
+	while (value >= 0x80)
+	{
+	    fout.put((char)(value | 0x80));
+	    value >>= 7;
+	}
+
+	fout.put((char) value);
+    }
+
+
+    void
+    BinaryFileWriter::write_string(const char* value)
+    {
+	size_t length = strlen(value);
+
+	write_number(length);
+	fout.write(value, length);
+    }
+
+
+    void
+    BinaryFileWriter::write_name(const char* name)
+    {
+	std::map<string, unsigned int>::const_iterator it = names.find(name);
+	if (it != names.end())
+	{
+	    write_number(it->second);
+	}
+	else
+	{
+	    unsigned int index = names.size();
+	    names[name] = index;
+
+	    write_number(index);
+	    write_string(name);
+	}
+    }
+
+
+    void
+    BinaryFileWriter::write_content(const xmlNode* node)
+    {
+	const xmlNode* children = node->children;
+
+	if (!children)
+	{
+	    fout.put(CONTENT_EMPTY);
+	}
+	else if (children->type == XML_TEXT_NODE && !children->next)
+	{
+	    fout.put(CONTENT_TEXT);
+	    write_string((const char*) children->content);
+	}
+	else
+	{
+	    unsigned int n = 0;
+
+	    for (const xmlNode* child = children; child; child = child->next)
+	    {
+		if (child->type != XML_ELEMENT_NODE)
+		    ST_THROW(Exception(sformat("unsupported content of node %s", (const char*) node->name)));
+
+		++n;
+	    }
+
+	    fout.put(CONTENT_ELEMENTS);
+	    write_number(n);
+
+	    for (const xmlNode* child = children; child; child = child->next)
+	    {
+		write_name((const char*) child->name);
+		write_content(child);
+	    }
+	}
+    }
+
+}
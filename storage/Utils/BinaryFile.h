@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_BINARY_FILE_H
+#define STORAGE_BINARY_FILE_H
+
+
+#include <libxml/tree.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <boost/noncopyable.hpp>
+
+
+namespace storage
+{
+    using std::string;
+    using std::vector;
+
+
+    /**
+     * Compact binary encoding of the XML nodes used for saving and
+     * loading, e.g. of devices and holders. Since the nodes are the same
+     * as for XML files the per-class save and load functions are used for
+     * both and any file can be converted between the formats without
+     * loss.
+     *
+     * The file starts with an eight byte magic and a version number,
+     * both defined by the user of the class, followed by records. Each
+     * record consists of a type byte and a node. Element names are
+     * stored only once and afterwards referenced by index. Numbers are
+     * stored as LEB128. Text is stored as length and bytes.
+     *
+     * Only elements with either a single text child, element children or
+     * no children are supported, as produced by setChildValue() and
+     * xmlNewChild().
+     */
+
+
+    /**
+     * Reads a binary file. The file is mapped into memory.
+     */
+    class BinaryFileReader : private boost::noncopyable
+    {
+
+    public:
+
+	/**
+	 * Open the file and check magic and version. Files with a version
+	 * newer than max_version are rejected since they may contain
+	 * records this reader cannot handle.
+	 *
+	 * @throw Exception
+	 */
+	BinaryFileReader(const string& filename, const char magic[8], unsigned int max_version);
+
+	~BinaryFileReader();
+
+	/**
+	 * Check whether the file starts with the magic. Does not throw.
+	 */
+	static bool has_magic(const string& filename, const char magic[8]);
+
+	unsigned int get_version() const { return version; }
+
+	/**
+	 * Read the next record. Returns false at the end of the file. The
+	 * node is only valid until the next call.
+	 *
+	 * @throw Exception
+	 */
+	bool next_record(char& type, const xmlNode*& node);
+
+    private:
+
+	unsigned long long read_number();
+	string read_string();
+	const string& read_name();
+	void read_content(xmlNode* node, unsigned int depth);
+
+	const string filename;
+
+	const unsigned char* data;
+	size_t size;
+	size_t pos;
+
+	unsigned int version;
+
+	vector<string> names;
+
+	xmlNode* current;
+
+    };
+
+
+    /**
+     * Writes a binary file record by record.
+     */
+    class BinaryFileWriter : private boost::noncopyable
+    {
+
+    public:
+
+	/**
+	 * @throw Exception
+	 */
+	BinaryFileWriter(const string& filename, const char magic[8], unsigned int version);
+
+	~BinaryFileWriter();
+
+	/**
+	 * Write the node including its subtree as a record of the given
+	 * type. The node is freed afterwards.
+	 *
+	 * @throw Exception
+	 */
+	void write_record(char type, xmlNode* node);
+
+	/**
+	 * Finish writing the file.
+	 *
+	 * @throw Exception
+	 */
+	void close();
+
+    private:
+
+	void write_number(unsigned long long value);
+	void write_string(const char* value);
+	void write_name(const char* name);
+	void write_content(const xmlNode* node);
+
+	const string filename;
+
+	std::ofstream fout;
+
+	std::map<string, unsigned int> names;
+
+    };
+
+}
+
+
+#endif
@@ -23,11 +23,17 @@
 
 #include <stdio.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 /* Not technically required, but needed on some UNIX distributions */
 #include <sys/types.h>
 #include <sys/stat.h>
 
 #include <iostream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
 
 #include "storage/Utils/Logger.h"
 #include "storage/Utils/AppUtil.h"
@@ -92,10 +98,21 @@ namespace storage
     }
 
 
+    /**
+     * Logger writing to a file. The file is kept open and lines are
+     * collected in a buffer that is written by a background thread at least
+     * once per second. Lines with level ERROR are written immediately, as is
+     * the buffer when the logger is destroyed at exit.
+     *
+     * Before writing the file is checked for having been renamed or removed
+     * (e.g. by logrotate) in which case it is reopened.
+     */
     class LogfileLogger : public Logger
     {
     public:
+
 	LogfileLogger(const std::string& filename, int permissions = DEFAULT_PERMISSIONS);
+	virtual ~LogfileLogger();
 
 	virtual void write(LogLevel log_level, const std::string& component, const std::string& file,
 			   int line, const std::string& function, const std::string& content) override;
@@ -105,16 +122,59 @@ namespace storage
 	// log file should not be world-readable
 	static const int DEFAULT_PERMISSIONS = 0640;
 
+	// buffer size at which the writer thread is woken up early
+	static const size_t FLUSH_SIZE = 64 * 1024;
+
+	void writer();
+
+	void flush();
+
+	void reopen_if_needed();
+
 	const std::string filename;
 	const int permissions;
-    };
 
+	int fd = -1;
+
+	// time and formatted time of the last line
+	time_t last_time = 0;
+	std::string last_datetime;
+
+	// protects buffer, stop and the timestamp cache
+	std::mutex buffer_mutex;
+	std::condition_variable buffer_condition;
+	std::string buffer;
+	bool stop = false;
+
+	// serializes flushes and protects fd
+	std::mutex write_mutex;
+
+	std::thread writer_thread;
+    };
 
 
     LogfileLogger::LogfileLogger(const string& filename, int permissions) :
 	filename(filename),
 	permissions(permissions)
     {
+	writer_thread = std::thread(&LogfileLogger::writer, this);
+    }
+
+
+    LogfileLogger::~LogfileLogger()
+    {
+	{
+	    std::lock_guard<std::mutex> lock(buffer_mutex);
+	    stop = true;
+	}
+
+	buffer_condition.notify_one();
+	writer_thread.join();
+
+	flush();
+
+	if (fd >= 0)
+	    close(fd);
     }
 
 
@@ -122,24 +182,122 @@ namespace storage
     LogfileLogger::write(LogLevel log_level, const std::string& component, const std::string& file,
 			 int line, const std::string& function, const std::string& content)
     {
-	int fd = open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, permissions);
+	time_t now = time(nullptr);
 
-	if (fd >= 0)
+	bool wakeup = false;
+
+	{
+	    std::lock_guard<std::mutex> lock(buffer_mutex);
+
+	    if (now != last_time || last_datetime.empty())
+	    {
+		last_time = now;
+		last_datetime = datetime(now);
+	    }
+
+	    buffer.append(last_datetime);
+	    buffer.append(" <");
+	    buffer.append(std::to_string(static_cast<log_level_underlying_type>(log_level)));
+	    buffer.append("> [");
+	    buffer.append(component.c_str());
+	    buffer.append("] ");
+	    buffer.append(file.c_str());
+	    buffer.append("(");
+	    buffer.append(function.c_str());
+	    buffer.append("):");
+	    buffer.append(std::to_string(line));
+	    buffer.append(" ");
+	    buffer.append(content.c_str());
+	    buffer.append("\n");
+
+	    wakeup = buffer.size() >= FLUSH_SIZE;
+	}
+
+	if (log_level == LogLevel::ERROR)
+	    flush();
+	else if (wakeup)
+	    buffer_condition.notify_one();
+    }
+
+
+    void
+    LogfileLogger::writer()
+    {
+	std::unique_lock<std::mutex> lock(buffer_mutex);
+
+	while (!stop)
 	{
-	    FILE* f = fdopen(fd, "ae");
+	    buffer_condition.wait_for(lock, std::chrono::seconds(1));
+
+	    if (!buffer.empty())
+	    {
+		lock.unlock();
+		flush();
+		lock.lock();
+	    }
+	}
+    }
+
+
+    void
+    LogfileLogger::flush()
+    {
+	std::lock_guard<std::mutex> write_lock(write_mutex);
+
+	string tmp;
+
+	{
+	    std::lock_guard<std::mutex> lock(buffer_mutex);
+	    tmp.swap(buffer);
+	}
+
+	if (tmp.empty())
+	    return;
 
-	    if (f)
+	reopen_if_needed();
+
+	if (fd < 0)
+	    return;
+
+	const char* p = tmp.data();
+	size_t todo = tmp.size();
+
+	while (todo > 0)
+	{
+	    ssize_t done = ::write(fd, p, todo);
+	    if (done < 0)
 	    {
-		fprintf(f, "%s <%d> [%s] %s(%s):%d %s\n", datetime(time(nullptr)).c_str(),
-			static_cast<log_level_underlying_type>(log_level), component.c_str(),
-			file.c_str(), function.c_str(), line, content.c_str());
+		if (errno == EINTR)
+		    continue;
 
-		fclose(f);
+		break;
 	    }
+
+	    p += done;
+	    todo -= done;
 	}
     }
 
 
+    void
+    LogfileLogger::reopen_if_needed()
+    {
+	if (fd >= 0)
+	{
+	    struct stat st1;
+	    struct stat st2;
+
+	    if (stat(filename.c_str(), &st1) == 0 && fstat(fd, &st2) == 0 &&
+		st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino)
+		return;
+
+	    close(fd);
+	}
+
+	fd = open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, permissions);
+    }
+
+
     Logger*
     get_logfile_logger(const std::string& filename)
     {
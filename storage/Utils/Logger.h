@@ -89,6 +89,9 @@ namespace storage
      *
      * Note that this method only uses the given filename the first time that
      * is called.
+     *
+     * Log lines are buffered and written at least once per second. Lines
+     * with log level ERROR are written immediately.
      */
     Logger* get_logfile_logger(const std::string& filename = "/var/log/libstorage.log");
 
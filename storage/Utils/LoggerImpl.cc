@@ -32,9 +32,16 @@ namespace storage
     static const string& component = "libstorage";
 
 
+    static thread_local LogBuffer* log_buffer = nullptr;
+
+
     bool
     query_log_level(LogLevel log_level)
     {
+	// The log level is checked when the log buffer is written.
+	if (log_buffer)
+	    return true;
+
 	Logger* logger = get_logger();
 	if (logger)
 	{
@@ -63,14 +70,13 @@ namespace storage
     }
 
 
-    void
-    close_log_stream(LogLevel log_level, const char* file, unsigned line, const char* func,
-		     ostringstream* stream)
+    static void
+    write_log_content(LogLevel log_level, const char* file, unsigned line, const char* func,
+		      const string& content)
     {
 	Logger* logger = get_logger();
 	if (logger)
 	{
-	    string content = stream->str();
 	    string::size_type pos1 = 0;
 	    while (true)
 	    {
@@ -83,8 +89,53 @@ namespace storage
 		pos1 = pos2 + 1;
 	    }
 	}
+    }
+
+
+    void
+    close_log_stream(LogLevel log_level, const char* file, unsigned line, const char* func,
+		     ostringstream* stream)
+    {
+	if (log_buffer)
+	    log_buffer->add(log_level, file, line, func, stream->str());
+	else
+	    write_log_content(log_level, file, line, func, stream->str());
 
 	delete stream;
     }
 
+
+    LogBuffer::Install::Install(LogBuffer& log_buffer)
+	: old_log_buffer(storage::log_buffer)
+    {
+	storage::log_buffer = &log_buffer;
+    }
+
+
+    LogBuffer::Install::~Install()
+    {
+	storage::log_buffer = old_log_buffer;
+    }
+
+
+    void
+    LogBuffer::add(LogLevel log_level, const char* file, unsigned line, const char* func,
+		   const string& content)
+    {
+	entries.push_back({ log_level, file, line, func, content });
+    }
+
+
+    void
+    LogBuffer::write()
+    {
+	for (const Entry& entry : entries)
+	{
+	    if (query_log_level(entry.log_level))
+		write_log_content(entry.log_level, entry.file, entry.line, entry.func, entry.content);
+	}
+
+	entries.clear();
+    }
+
 }
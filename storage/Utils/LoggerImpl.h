@@ -26,6 +26,8 @@
 
 
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "storage/Utils/Logger.h"
 
@@ -33,6 +35,58 @@
 namespace storage
 {
 
+    /**
+     * Collects the log lines of the current thread instead of passing them
+     * to the logger. Used in worker threads since the logger, e.g. one
+     * implemented in Ruby, might not be thread-safe. The collected lines
+     * must be written with write() by the main thread.
+     */
+    class LogBuffer
+    {
+    public:
+
+	/**
+	 * Installs the log buffer for the current thread until the object is
+	 * destructed.
+	 */
+	class Install
+	{
+	public:
+
+	    Install(LogBuffer& log_buffer);
+	    ~Install();
+
+	private:
+
+	    LogBuffer* old_log_buffer;
+
+	};
+
+	void add(LogLevel log_level, const char* file, unsigned line, const char* func,
+		 const std::string& content);
+
+	/**
+	 * Passes the collected log lines to the logger and clears the log
+	 * buffer.
+	 */
+	void write();
+
+    private:
+
+	struct Entry
+	{
+	    LogLevel log_level;
+	    const char* file;
+	    unsigned line;
+	    const char* func;
+	    std::string content;
+	};
+
+	std::vector<Entry> entries;
+
+    };
+
+
     bool query_log_level(LogLevel log_level);
 
     std::ostringstream* open_log_stream();
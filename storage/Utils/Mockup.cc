@@ -21,6 +21,9 @@
  */
 
 
+#include <unordered_map>
+#include <boost/functional/hash.hpp>
+
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/ExceptionImpl.h"
@@ -31,24 +34,122 @@
 namespace storage
 {
 
+    namespace
+    {
+
+	void
+	hash_lines(size_t& seed, const vector<string>& lines)
+	{
+	    boost::hash_combine(seed, lines.size());
+
+	    for (const string& line : lines)
+		boost::hash_combine(seed, line);
+	}
+
+
+	size_t
+	hash_value(const Mockup::Command& command)
+	{
+	    size_t seed = 0;
+	    hash_lines(seed, command.stdout);
+	    hash_lines(seed, command.stderr);
+	    boost::hash_combine(seed, command.exit_code);
+	    return seed;
+	}
+
+
+	size_t
+	hash_value(const Mockup::File& file)
+	{
+	    size_t seed = 0;
+	    hash_lines(seed, file.content);
+	    return seed;
+	}
+
+
+	/**
+	 * Pool of the commands or files of the mockup indexed by the hash of
+	 * their content. Used to share identical entries, e.g. the udevadm
+	 * output of a device recorded under several of its names, between
+	 * the names.
+	 */
+	template <typename Type>
+	class Pool
+	{
+	public:
+
+	    Pool(const map<string, shared_ptr<const Type>>& entries)
+	    {
+		for (const typename map<string, shared_ptr<const Type>>::value_type& tmp : entries)
+		    index.emplace(hash_value(*tmp.second), tmp.second);
+	    }
+
+	    /**
+	     * Return the entry in the pool identical to the value or add the
+	     * value to the pool. The shared flag is set if an identical
+	     * entry was already in the pool.
+	     */
+	    shared_ptr<const Type> intern(Type&& value, bool& shared)
+	    {
+		const size_t hash = hash_value(value);
+
+		auto range = index.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+		    if (*it->second == value)
+		    {
+			shared = true;
+			return it->second;
+		    }
+		}
+
+		shared = false;
+
+		shared_ptr<const Type> entry = make_shared<const Type>(std::move(value));
+		index.emplace(hash, entry);
+		return entry;
+	    }
+
+	private:
+
+	    std::unordered_multimap<size_t, shared_ptr<const Type>> index;
+
+	};
+
+    }
+
+
     void
     Mockup::load(const string& filename)
     {
-	XmlFile xml(filename);
+	// The file is read entry by entry since mockups can be huge.
+
+	XmlFileReader reader(filename);
 
-	const xmlNode* root_node = xml.getRootElement();
-	if (!root_node)
-	    ST_THROW(Exception("root node not found"));
+	Pool<Command> command_pool(commands);
+	Pool<File> file_pool(files);
 
-	const xmlNode* mockup_node = getChildNode(root_node, "Mockup");
-	if (!mockup_node)
-	    ST_THROW(Exception("Mockup node not found"));
+	string section;
 
-	const xmlNode* commands_node = getChildNode(mockup_node, "Commands");
-	if (commands_node)
+	while (reader.next_element())
 	{
-	    for (const xmlNode* command_node : getChildNodes(commands_node))
+	    const int depth = reader.depth();
+
+	    if (depth == 0)
+	    {
+		if (reader.name() != "Mockup")
+		    ST_THROW(Exception("Mockup node not found"));
+	    }
+	    else if (depth == 1)
 	    {
+		section = reader.name();
+	    }
+	    else if (depth == 2 && section == "Commands")
+	    {
+		const xmlNode* command_node = reader.expand();
+		if (!command_node)
+		    continue;
+
 		vector<string> names;
 		getChildValue(command_node, "name", names);
 
@@ -60,38 +161,34 @@ namespace storage
 		getChildValue(command_node, "stderr", command.stderr);
 		getChildValue(command_node, "exit-code", command.exit_code);
 
+		bool shared;
+		shared_ptr<const Command> entry = command_pool.intern(std::move(command), shared);
+
 #ifdef OCCAMS_RAZOR
 		// Unfortunately the check is not so effective as one
 		// might expected since the output of udevadm info is
 		// often sorted differently depending on the
 		// parameter.
 
-		if (command.stdout.size() > threshold)
+		if (shared && entry->stdout.size() > threshold)
 		{
-		    for (const map<string, Command>::value_type& tmp : commands)
-		    {
-			if (tmp.second == command)
-			{
-			    y2err("identical commands in mockup '" << tmp.first << "' and '" << names[0]);
-			    ST_THROW(Exception("Occam's Razor"));
-			}
-		    }
+		    y2err("identical commands in mockup for '" << names[0] << "'");
+		    ST_THROW(Exception("Occam's Razor"));
 		}
 #endif
 
 		for (const string& name : names)
 		{
-		    if (!commands.emplace(name, command).second)
+		    if (!commands.emplace(name, entry).second)
 			ST_THROW(Exception(sformat("command \"%s\" already loaded for mockup", name)));
 		}
 	    }
-	}
-
-	const xmlNode* files_node = getChildNode(mockup_node, "Files");
-	if (files_node)
-	{
-	    for (const xmlNode* file_node : getChildNodes(files_node))
+	    else if (depth == 2 && section == "Files")
 	    {
+		const xmlNode* file_node = reader.expand();
+		if (!file_node)
+		    continue;
+
 		vector<string> names;
 		getChildValue(file_node, "name", names);
 
@@ -101,23 +198,20 @@ namespace storage
 		File file;
 		getChildValue(file_node, "content", file.content);
 
+		bool shared;
+		shared_ptr<const File> entry = file_pool.intern(std::move(file), shared);
+
 #ifdef OCCAMS_RAZOR
-		if (file.content.size() > threshold)
+		if (shared && entry->content.size() > threshold)
 		{
-		    for (const map<string, File>::value_type& tmp : files)
-		    {
-			if (tmp.second == file)
-			{
-			    y2err("identical files in mockup '" << tmp.first << "' and '" << names[0]);
-			    ST_THROW(Exception("Occam's Razor"));
-			}
-		    }
+		    y2err("identical files in mockup for '" << names[0] << "'");
+		    ST_THROW(Exception("Occam's Razor"));
 		}
 #endif
 
 		for (const string& name : names)
 		{
-		    if (!files.emplace(name, file).second)
+		    if (!files.emplace(name, entry).second)
 			ST_THROW(Exception(sformat("file \"%s\" already loaded for mockup", name)));
 		}
 	    }
@@ -140,14 +234,14 @@ namespace storage
 	{
 	    xmlNode* commands_node = xmlNewChild(mockup_node, "Commands");
 
-	    for (const map<string, Command>::value_type& it : commands)
+	    for (const map<string, shared_ptr<const Command>>::value_type& it : commands)
 	    {
 		xmlNode* command_node = xmlNewChild(commands_node, "Command");
 
 		setChildValue(command_node, "name", it.first);
-		setChildValue(command_node, "stdout", it.second.stdout);
-		setChildValue(command_node, "stderr", it.second.stderr);
-		setChildValueIf(command_node, "exit-code", it.second.exit_code, it.second.exit_code != 0);
+		setChildValue(command_node, "stdout", it.second->stdout);
+		setChildValue(command_node, "stderr", it.second->stderr);
+		setChildValueIf(command_node, "exit-code", it.second->exit_code, it.second->exit_code != 0);
 	    }
 	}
 
@@ -155,12 +249,12 @@ namespace storage
 	{
 	    xmlNode* files_node = xmlNewChild(mockup_node, "Files");
 
-	    for (const map<string, File>::value_type& it : files)
+	    for (const map<string, shared_ptr<const File>>::value_type& it : files)
 	    {
 		xmlNode* file_node = xmlNewChild(files_node, "File");
 
 		setChildValue(file_node, "name", it.first);
-		setChildValue(file_node, "content", it.second.content);
+		setChildValue(file_node, "content", it.second->content);
 	    }
 	}
 
@@ -178,7 +272,7 @@ namespace storage
     const Mockup::Command&
     Mockup::get_command(const string& name)
     {
-	map<string, Command>::const_iterator it = commands.find(name);
+	map<string, shared_ptr<const Command>>::const_iterator it = commands.find(name);
 	if (it == commands.end())
 	    ST_THROW(Exception("no mockup found for command '" + name + "'"));
 
@@ -186,14 +280,14 @@ namespace storage
 	used_commands.insert(name);
 #endif
 
-	return it->second;
+	return *it->second;
     }
 
 
     void
     Mockup::set_command(const string& name, const Command& command)
     {
-	commands[name] = command;
+	commands[name] = make_shared<const Command>(command);
     }
 
 
@@ -214,7 +308,7 @@ namespace storage
     const Mockup::File&
     Mockup::get_file(const string& name)
     {
-	map<string, File>::const_iterator it = files.find(name);
+	map<string, shared_ptr<const File>>::const_iterator it = files.find(name);
 	if (it == files.end())
 	    ST_THROW(Exception("no mockup found for file '" + name + "'"));
 
@@ -222,14 +316,14 @@ namespace storage
 	used_files.insert(name);
 #endif
 
-	return it->second;
+	return *it->second;
     }
 
 
     void
     Mockup::set_file(const string& name, const File& file)
     {
-	files[name] = file;
+	files[name] = make_shared<const File>(file);
     }
 
 
@@ -247,7 +341,7 @@ namespace storage
 
 	bool ok = true;
 
-	for (const map<string, Command>::value_type& tmp : commands)
+	for (const map<string, shared_ptr<const Command>>::value_type& tmp : commands)
 	{
 	    if (used_commands.count(tmp.first) == 0)
 	    {
@@ -256,7 +350,7 @@ namespace storage
 	    }
 	}
 
-	for (const map<string, File>::value_type& tmp : files)
+	for (const map<string, shared_ptr<const File>>::value_type& tmp : files)
 	{
 	    if (used_files.count(tmp.first) == 0)
 	    {
@@ -274,8 +368,8 @@ namespace storage
 
     Mockup::Mode Mockup::mode = Mockup::Mode::NONE;
 
-    map<string, Mockup::Command> Mockup::commands;
-    map<string, Mockup::File> Mockup::files;
+    map<string, shared_ptr<const Mockup::Command>> Mockup::commands;
+    map<string, shared_ptr<const Mockup::File>> Mockup::files;
 
 #ifdef OCCAMS_RAZOR
     set<string> Mockup::used_commands;
@@ -28,6 +28,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <memory>
 
 #include "storage/Utils/Remote.h"
 
@@ -85,8 +86,10 @@ namespace storage
 
 	static Mode mode;
 
-	static map<string, Command> commands;
-	static map<string, File> files;
+	// Identical commands and files share the entry.
+
+	static map<string, std::shared_ptr<const Command>> commands;
+	static map<string, std::shared_ptr<const File>> files;
 
 #ifdef OCCAMS_RAZOR
 	const static size_t threshold = 4;
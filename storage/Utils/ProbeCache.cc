@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <functional>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Utils/ProbeCache.h"
+#include "storage/Utils/XmlFile.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/AppUtil.h"
+#include "storage/Utils/Format.h"
+
+
+namespace storage
+{
+
+    std::mutex ProbeCache::mutex;
+
+    bool ProbeCache::active = false;
+    bool ProbeCache::modified = false;
+
+    string ProbeCache::filename;
+    string ProbeCache::current_generation;
+
+    map<string, RemoteCommand> ProbeCache::commands;
+
+
+    namespace
+    {
+
+	/**
+	 * Commands that only read the state of the system and whose output
+	 * only depends on what the generation covers.
+	 */
+	const vector<string> cacheable_commands = {
+	    PARTED_BIN " --script --machine ",
+	    BLKID_BIN " ",
+	    PVS_BIN " ",
+	    VGS_BIN " ",
+	    LVS_BIN " ",
+	    MDADM_BIN " --detail ",
+	    MDADM_BIN " --examine ",
+	    CRYPTSETUP_BIN " luksDump ",
+	    DMSETUP_BIN " ",
+	    DASDVIEW_BIN " ",
+	    BTRFS_BIN " filesystem show"
+	};
+
+
+	void
+	add_file(std::ostringstream& out, const string& path)
+	{
+	    std::ifstream in(path);
+	    out << path << '\n' << in.rdbuf() << '\n';
+	}
+
+
+	void
+	add_mtime(std::ostringstream& out, const string& path)
+	{
+	    struct stat buf;
+	    if (stat(path.c_str(), &buf) == 0)
+		out << path << ' ' << buf.st_mtim.tv_sec << '.' << buf.st_mtim.tv_nsec << '\n';
+	}
+
+
+	vector<string>
+	list_dir(const string& path)
+	{
+	    vector<string> entries;
+
+	    DIR* dir = opendir(path.c_str());
+	    if (dir)
+	    {
+		while (const struct dirent* entry = readdir(dir))
+		{
+		    if (entry->d_name[0] != '.')
+			entries.push_back(entry->d_name);
+		}
+
+		closedir(dir);
+	    }
+
+	    sort(entries.begin(), entries.end());
+
+	    return entries;
+	}
+
+    }
+
+
+    void
+    ProbeCache::activate(const string& filename)
+    {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	ProbeCache::filename = filename;
+	current_generation = generation();
+
+	commands.clear();
+	modified = false;
+
+	try
+	{
+	    load();
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    commands.clear();
+	}
+
+	y2mil("probe cache activated, generation " << current_generation << ", " <<
+	      commands.size() << " entries");
+
+	active = true;
+    }
+
+
+    void
+    ProbeCache::deactivate()
+    {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!active)
+	    return;
+
+	active = false;
+
+	if (modified)
+	{
+	    if (generation() == current_generation)
+		save();
+	    else
+		y2mil("generation changed while probing, probe cache not saved");
+	}
+
+	commands.clear();
+    }
+
+
+    bool
+    ProbeCache::is_cacheable(const string& name)
+    {
+	return any_of(cacheable_commands.begin(), cacheable_commands.end(), [&name](const string& prefix) {
+	    return boost::starts_with(name, prefix);
+	});
+    }
+
+
+    bool
+    ProbeCache::lookup(const string& name, RemoteCommand& command)
+    {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!active)
+	    return false;
+
+	map<string, RemoteCommand>::const_iterator it = commands.find(name);
+	if (it == commands.end())
+	    return false;
+
+	command = it->second;
+
+	return true;
+    }
+
+
+    void
+    ProbeCache::store(const string& name, const RemoteCommand& command)
+    {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!active)
+	    return;
+
+	commands[name] = command;
+	modified = true;
+    }
+
+
+    string
+    ProbeCache::generation()
+    {
+	std::ostringstream out;
+
+	add_file(out, PROC_DIR "/sys/kernel/random/boot_id");
+	add_file(out, PROC_DIR "/mounts");
+	add_file(out, PROC_DIR "/mdstat");
+
+	add_mtime(out, "/etc/lvm/backup");
+
+	for (const string& name : list_dir(SYSFS_DIR "/class/block"))
+	{
+	    const string path = SYSFS_DIR "/class/block/" + name;
+
+	    std::ifstream in(path + "/dev");
+	    string dev;
+	    in >> dev;
+
+	    out << name << ' ' << dev << '\n';
+	    add_file(out, path + "/size");
+	    add_file(out, path + "/ro");
+
+	    if (!dev.empty())
+		add_mtime(out, "/run/udev/data/b" + dev);
+	}
+
+	std::ostringstream hash;
+	hash << std::hex << std::setw(16) << std::setfill('0') << std::hash<string>()(out.str());
+
+	return hash.str();
+    }
+
+
+    void
+    ProbeCache::load()
+    {
+	if (access(filename.c_str(), R_OK) != 0)
+	    return;
+
+	XmlFile xml(filename);
+
+	const xmlNode* root_node = xml.getRootElement();
+	if (!root_node)
+	    ST_THROW(Exception("root node not found"));
+
+	const xmlNode* probe_cache_node = getChildNode(root_node, "ProbeCache");
+	if (!probe_cache_node)
+	    ST_THROW(Exception("ProbeCache node not found"));
+
+	string generation;
+	getChildValue(probe_cache_node, "generation", generation);
+	if (generation != current_generation)
+	{
+	    y2mil("probe cache generation " << generation << " is outdated");
+	    return;
+	}
+
+	const xmlNode* commands_node = getChildNode(probe_cache_node, "Commands");
+	if (commands_node)
+	{
+	    for (const xmlNode* command_node : getChildNodes(commands_node))
+	    {
+		string name;
+		getChildValue(command_node, "name", name);
+
+		RemoteCommand command;
+		getChildValue(command_node, "stdout", command.stdout);
+		getChildValue(command_node, "stderr", command.stderr);
+		getChildValue(command_node, "exit-code", command.exit_code);
+
+		commands[name] = command;
+	    }
+	}
+    }
+
+
+    void
+    ProbeCache::save() noexcept
+    {
+	// Write to a temporary file first so that concurrent readers never
+	// see a partial cache file.
+
+	const string tmp_filename = filename + ".tmp";
+
+	try
+	{
+	    if (mkdir(dirname(filename).c_str(), 0755) == -1 && errno != EEXIST)
+		ST_THROW(IOException(sformat("mkdir of '%s' failed", dirname(filename))));
+
+	    XmlFile xml;
+
+	    xmlNode* probe_cache_node = xmlNewNode("ProbeCache");
+	    xml.setRootElement(probe_cache_node);
+
+	    xmlNode* comment = xmlNewComment(string(" " + generated_string() + " ").c_str());
+	    xmlAddPrevSibling(probe_cache_node, comment);
+
+	    setChildValue(probe_cache_node, "generation", current_generation);
+
+	    xmlNode* commands_node = xmlNewChild(probe_cache_node, "Commands");
+
+	    for (const map<string, RemoteCommand>::value_type& it : commands)
+	    {
+		xmlNode* command_node = xmlNewChild(commands_node, "Command");
+
+		setChildValue(command_node, "name", it.first);
+		setChildValue(command_node, "stdout", it.second.stdout);
+		setChildValue(command_node, "stderr", it.second.stderr);
+		setChildValueIf(command_node, "exit-code", it.second.exit_code, it.second.exit_code != 0);
+	    }
+
+	    xml.save_to_file(tmp_filename);
+
+	    if (rename(tmp_filename.c_str(), filename.c_str()) != 0)
+		ST_THROW(IOException(sformat("rename of '%s' failed", tmp_filename)));
+
+	    y2mil("probe cache saved, " << commands.size() << " entries");
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    unlink(tmp_filename.c_str());
+	}
+    }
+
+}
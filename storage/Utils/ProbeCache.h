@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_PROBE_CACHE_H
+#define STORAGE_PROBE_CACHE_H
+
+
+#include <string>
+#include <map>
+#include <mutex>
+
+#include "storage/Utils/Remote.h"
+
+
+namespace storage
+{
+    using std::string;
+    using std::map;
+
+
+    /**
+     * Cache for the output of the commands run during probing that only
+     * read the state of the system, e.g. parted, blkid and the LVM
+     * reporting commands. The cache is saved to a file, using the format
+     * of the mockup, and used by the next probe if the generation of the
+     * system did not change in between.
+     *
+     * The generation is computed from cheap invariants: the block devices
+     * with their dev and size in sysfs, the modification times of their
+     * udev database entries (udev processes a change event whenever a
+     * block device opened for writing is closed, e.g. after writing a
+     * partition table, a filesystem or LVM metadata), /proc/mounts,
+     * /proc/mdstat, the LVM metadata backup directory and the boot id.
+     *
+     * Changes not visible in any of these invariants, e.g. creating a
+     * btrfs subvolume, are not detected. Thus commands depending on such
+     * changes are not cached.
+     */
+    class ProbeCache
+    {
+    public:
+
+	/**
+	 * Activate the cache. Loads the cache file if it exists and has
+	 * the current generation of the system.
+	 */
+	static void activate(const string& filename);
+
+	/**
+	 * Deactivate the cache. Saves the cache file if new entries were
+	 * added and the generation of the system did not change while
+	 * the cache was active.
+	 */
+	static void deactivate();
+
+	/**
+	 * Whether the output of the command may be cached.
+	 */
+	static bool is_cacheable(const string& name);
+
+	/**
+	 * Lookup the command in the cache. Returns false if the command is
+	 * not cached or the cache is not active.
+	 */
+	static bool lookup(const string& name, RemoteCommand& command);
+
+	/**
+	 * Store the command in the cache if the cache is active.
+	 */
+	static void store(const string& name, const RemoteCommand& command);
+
+	/**
+	 * Compute the generation of the system.
+	 */
+	static string generation();
+
+    private:
+
+	static void load();
+	static void save() noexcept;
+
+	static std::mutex mutex;
+
+	static bool active;
+	static bool modified;
+
+	static string filename;
+	static string current_generation;
+
+	static map<string, RemoteCommand> commands;
+
+    };
+
+}
+
+
+#endif
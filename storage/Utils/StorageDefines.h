@@ -48,6 +48,8 @@
 #define DEV_ZERO_FILE DEV_DIR "/zero"
 #define DEV_URANDOM_FILE DEV_DIR "/urandom"
 
+#define PROBE_CACHE_FILE "/run/libstorage-ng/probe-cache.xml"
+
 
 // commands
 
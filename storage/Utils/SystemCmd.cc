@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <spawn.h>
 #include <sys/wait.h>
 #include <string>
 #include <sstream>
@@ -32,11 +33,13 @@
 
 extern char **environ;
 
+#include "config.h"
 #include "storage/Utils/ExceptionImpl.h"
 #include "storage/Utils/Stopwatch.h"
 #include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/ProbeCache.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/AppUtil.h"
 
@@ -106,8 +109,7 @@ namespace storage
     void
     SystemCmd::init()
     {
-        _childStdin = NULL;
-	_files[0] = _files[1] = NULL;
+	_pfds[0].fd = _pfds[1].fd = _pfds[2].fd = -1;
 	_pfds[0].events = POLLOUT; // stdin
 	_pfds[1].events = POLLIN;  // stdout
 	_pfds[2].events = POLLIN;  // stderr
@@ -117,22 +119,13 @@ namespace storage
     void
     SystemCmd::cleanup()
     {
-        if ( _childStdin )
-        {
-            fclose( _childStdin );
-            _childStdin = NULL;
-        }
-
-	if ( _files[IDX_STDOUT] )
-	{
-	    fclose( _files[IDX_STDOUT] );
-	    _files[IDX_STDOUT] = NULL;
-	}
-
-	if ( _files[IDX_STDERR] )
+	for (struct pollfd& pfd : _pfds)
 	{
-	    fclose( _files[IDX_STDERR] );
-	    _files[IDX_STDERR] = NULL;
+	    if (pfd.fd >= 0)
+	    {
+		close(pfd.fd);
+		pfd.fd = -1;
+	    }
 	}
     }
 
@@ -143,18 +136,6 @@ namespace storage
     }
 
 
-    void
-    SystemCmd::closeOpenFds() const
-    {
-	int max_fd = getdtablesize();
-
-	for ( int fd = 3; fd < max_fd; fd++ )
-	{
-	    close(fd);
-	}
-    }
-
-
     int
     SystemCmd::execute()
     {
@@ -185,9 +166,26 @@ namespace storage
 	}
 	else
 	{
-	    y2mil("SystemCmd Executing:\"" << command() << "\"");
-	    y2mil("timestamp " << timestamp());
-	    ret = doExecute();
+	    const bool cacheable = ProbeCache::is_cacheable(mockup_key());
+
+	    RemoteCommand cached_command;
+	    if (cacheable && ProbeCache::lookup(mockup_key(), cached_command))
+	    {
+		y2mil("SystemCmd Cached:\"" << command() << "\"");
+		_outputLines[IDX_STDOUT] = cached_command.stdout;
+		_outputLines[IDX_STDERR] = cached_command.stderr;
+		_cmdRet = cached_command.exit_code;
+		ret = 0;
+	    }
+	    else
+	    {
+		y2mil("SystemCmd Executing:\"" << command() << "\"");
+		y2mil("timestamp " << timestamp());
+		ret = doExecute();
+
+		if (cacheable && _cmdRet >= 0 && _cmdRet < SHELL_RET_COMMAND_NOT_EXECUTABLE)
+		    ProbeCache::store(mockup_key(), RemoteCommand(stdout(), stderr(), retcode()));
+	    }
 	}
 
 	if (Mockup::get_mode() == Mockup::Mode::RECORD)
@@ -206,142 +204,108 @@ namespace storage
 
 	Stopwatch stopwatch;
 
-        _childStdin = NULL;
-	_files[IDX_STDERR] = _files[IDX_STDOUT] = NULL;
 	invalidate();
+
+	// All pipes are created with close-on-exec. Only the ends duplicated
+	// to stdin, stdout and stderr of the child stay open in the child.
+
 	int sin[2];
 	int sout[2];
 	int serr[2];
-	bool ok = true;
-	if ( pipe(sin)<0 )
+
+	if (pipe2(sin, O_CLOEXEC) < 0)
 	{
-	    SYSCALL_FAILED( "pipe stdin creation failed" );
-	    ok = false;
+	    SYSCALL_FAILED("pipe stdin creation failed");
+	    return _cmdRet = -1;
 	}
-	if ( pipe(sout)<0 )
+
+	if (pipe2(sout, O_CLOEXEC) < 0)
 	{
-	    SYSCALL_FAILED( "pipe stdout creation failed" );
-	    ok = false;
+	    close(sin[0]);
+	    close(sin[1]);
+	    SYSCALL_FAILED("pipe stdout creation failed");
+	    return _cmdRet = -1;
 	}
-	if ( pipe(serr)<0 )
+
+	if (pipe2(serr, O_CLOEXEC) < 0)
 	{
-	    SYSCALL_FAILED( "pipe stderr creation failed" );
-	    ok = false;
+	    close(sin[0]);
+	    close(sin[1]);
+	    close(sout[0]);
+	    close(sout[1]);
+	    SYSCALL_FAILED("pipe stderr creation failed");
+	    return _cmdRet = -1;
 	}
-	if ( ok )
+
+	_pfds[0].fd = sin[1];
+	_pfds[1].fd = sout[0];
+	_pfds[2].fd = serr[0];
+
+	for (const struct pollfd& pfd : _pfds)
 	{
-	    _pfds[0].fd = sin[1];
-	    if ( fcntl( _pfds[0].fd, F_SETFL, O_NONBLOCK )<0 )
-	    {
-		SYSCALL_FAILED( "fcntl O_NONBLOCK failed for stdin" );
-	    }
-	    _pfds[1].fd = sout[0];
-	    if ( fcntl( _pfds[1].fd, F_SETFL, O_NONBLOCK )<0 )
+	    if (fcntl(pfd.fd, F_SETFL, O_NONBLOCK) < 0)
+		SYSCALL_FAILED("fcntl O_NONBLOCK failed");
+	}
+
+	y2deb("sout:" << _pfds[1].fd << " serr:" << _pfds[2].fd);
+
+	const vector<const char*> argv = make_argv();
+	const vector<const char*> env = make_env();
+
+	posix_spawn_file_actions_t file_actions;
+	posix_spawn_file_actions_init(&file_actions);
+	posix_spawn_file_actions_adddup2(&file_actions, sin[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, sout[1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, serr[1], STDERR_FILENO);
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+	posix_spawn_file_actions_addclosefrom_np(&file_actions, STDERR_FILENO + 1);
+#endif
+
+	pid_t pid = 0;
+	int spawn_ret = posix_spawnp(&pid, argv[0], &file_actions, nullptr,
+				     const_cast<char* const*>(&argv[0]), const_cast<char* const*>(&env[0]));
+	_cmdPid = pid;
+
+	posix_spawn_file_actions_destroy(&file_actions);
+
+	close(sin[0]);
+	close(sout[1]);
+	close(serr[1]);
+
+	if (spawn_ret != 0)
+	{
+	    cleanup();
+
+	    y2err("posix_spawn failed for \"" << command() << "\", " << stringerror(spawn_ret));
+
+	    // Use the same exit codes as the shell.
+
+	    if (spawn_ret == ENOENT)
 	    {
-		SYSCALL_FAILED( "fcntl O_NONBLOCK failed for stdout" );
+		_cmdRet = SHELL_RET_COMMAND_NOT_FOUND;
+		ST_MAYBE_THROW(CommandNotFoundException(this), do_throw());
 	    }
-	    _pfds[2].fd = serr[0];
-	    if ( fcntl( _pfds[2].fd, F_SETFL, O_NONBLOCK )<0 )
+	    else
 	    {
-		SYSCALL_FAILED( "fcntl O_NONBLOCK failed for stderr" );
+		_cmdRet = SHELL_RET_COMMAND_NOT_EXECUTABLE;
+		ST_MAYBE_THROW(SystemCmdException(this, "Command not executable"), do_throw());
 	    }
-	    y2deb("sout:" << _pfds[1].fd << " serr:" << _pfds[2].fd);
-
-	    const vector<const char*> env = make_env();
 
-	    switch( (_cmdPid=fork()) )
-	    {
-		case 0: // child process
-
-		    if ( dup2( sin[0], STDIN_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stdin failed in child process" );
-		    }
-		    if ( dup2( sout[1], STDOUT_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stdout failed in child process" );
-		    }
-		    if ( dup2( serr[1], STDERR_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stderr failed in child process" );
-		    }
-		    if ( close( sin[1] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdin ) failed in child process" );
-		    }
-		    if ( close( sout[0] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdout ) failed in child process" );
-		    }
-		    if ( close( serr[0] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stderr ) failed in child process" );
-		    }
-		    closeOpenFds();
-		    _cmdRet = execle(SH_BIN, SH_BIN, "-c", command().c_str(), nullptr, &env[0]);
-
-		    // execle() should not return. If we get here, it failed.
-		    // Throwing an exception here would not make any sense, however:
-		    // We are in the forked child process, and there is nothing
-		    // to return to that could make use of an exception.
-		    y2err("execle() failed: THIS SHOULD NOT HAPPEN \"SH_BIN\" Ret:" <<
-			  _cmdRet << " errno: " << errno);
-		    y2err( "Exiting child process" );
-		    exit(127); // same as "command not found" in the shell
-		    break;
-
-		case -1:
-		    _cmdRet = -1;
-		    SYSCALL_FAILED( "fork() failed" );
-		    break;
-
-		default: // parent process
-		    if ( close( sin[0] ) < 0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdin ) in parent failed" );
-		    }
-		    if ( close( sout[1] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdout ) in parent failed" );
-		    }
-		    if ( close( serr[1] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stderr ) in parent failed" );
-		    }
-		    _cmdRet = 0;
-
-                    _childStdin = fdopen( sin[1], "a" );
-		    if ( _childStdin == NULL )
-		    {
-			SYSCALL_FAILED_NOTHROW( "fdopen( stdin ) failed" );
-		    }
-
-		    _files[IDX_STDOUT] = fdopen( sout[0], "r" );
-		    if ( _files[IDX_STDOUT] == NULL )
-		    {
-			SYSCALL_FAILED_NOTHROW( "fdopen( stdout ) failed" );
-		    }
-		    _files[IDX_STDERR] = fdopen( serr[0], "r" );
-		    if ( _files[IDX_STDERR] == NULL )
-		    {
-			SYSCALL_FAILED_NOTHROW( "fdopen( stderr ) failed" );
-		    }
-
-		    doWait( _cmdRet );
-		    y2mil("stopwatch " << stopwatch << " for \"" << command() << "\"");
-
-		    break;
-	    }
-	}
-	else
-	{
-	    _cmdRet = -1;
+	    return _cmdRet;
 	}
+
+	if (options.stdin_text.empty())
+	    sendStdin();
+
+	_cmdRet = 0;
+
+	doWait(_cmdRet);
+	y2mil("stopwatch " << stopwatch << " for \"" << command() << "\"");
+
 	if ( _cmdRet==-127 || _cmdRet==-1 )
 	{
 	    y2err("system (\"" << command() << "\") = " << _cmdRet);
 	}
-	checkOutput();
 	y2mil("system() Returns:" << _cmdRet);
 	if ( _cmdRet!=0 )
 	    logOutput();
@@ -357,38 +321,43 @@ namespace storage
 
 	do
 	{
-	    y2deb("[1] fd:" << _pfds[1].fd << " ev:" << hex << (unsigned)(_pfds[1].events) << dec << " "
-		  "[2] fd:" << _pfds[2].fd << " ev:" << hex << (unsigned)(_pfds[2].events));
-	    int sel = poll( _pfds, 3, 1000 );
-	    if (sel < 0)
-	    {
-		SYSCALL_FAILED_NOTHROW( "poll() failed" );
-	    }
-	    y2deb("poll ret:" << sel);
-	    if ( sel>0 )
+	    // Once all pipes are closed only waiting for the child is left.
+	    // The child can exit while a process started by it still keeps
+	    // the pipes open, so also check for the child regularly.
+
+	    bool open = _pfds[0].fd >= 0 || _pfds[1].fd >= 0 || _pfds[2].fd >= 0;
+
+	    if (open)
 	    {
-                if ( _pfds[0].revents )
-                    sendStdin();
-                if ( _pfds[1].revents || _pfds[2].revents )
-                    checkOutput();
+		int sel = poll( _pfds, 3, 1000 );
+		if (sel < 0 && errno != EINTR)
+		{
+		    SYSCALL_FAILED_NOTHROW( "poll() failed" );
+		}
+		y2deb("poll ret:" << sel);
+		if ( sel>0 )
+		{
+		    if ( _pfds[0].revents )
+			sendStdin();
+		    if ( _pfds[1].revents )
+			readOutput(IDX_STDOUT);
+		    if ( _pfds[2].revents )
+			readOutput(IDX_STDERR);
+		}
 	    }
-	    waitpidRet = waitpid( _cmdPid, &cmdStatus, WNOHANG );
+
+	    waitpidRet = waitpid( _cmdPid, &cmdStatus, open ? WNOHANG : 0 );
 	    y2deb("Wait ret:" << waitpidRet);
 	}
-	while ( waitpidRet == 0 );
+	while ( waitpidRet == 0 || (waitpidRet < 0 && errno == EINTR) );
 
-	if ( waitpidRet != 0 )
+	if ( waitpidRet > 0 )
 	{
-	    checkOutput();
-            if ( _childStdin )
-            {
-                fclose( _childStdin );
-                _childStdin = NULL;
-            }
-	    fclose( _files[IDX_STDOUT] );
-	    _files[IDX_STDOUT] = NULL;
-	    fclose( _files[IDX_STDERR] );
-	    _files[IDX_STDERR] = NULL;
+	    readOutput(IDX_STDOUT);
+	    readOutput(IDX_STDERR);
+	    flushOutput();
+	    cleanup();
+
 	    if (WIFEXITED(cmdStatus))
 	    {
 		cmdRet_ret = WEXITSTATUS(cmdStatus);
@@ -409,10 +378,16 @@ namespace storage
 		ST_MAYBE_THROW(SystemCmdException(this, "Command failed"), do_throw());
 	    }
 	}
+	else
+	{
+	    cleanup();
+	    cmdRet_ret = -1;
+	    SYSCALL_FAILED_NOTHROW( "waitpid() failed" );
+	}
 
 	y2deb("Wait:" << waitpidRet << " pid:" << _cmdPid << " stat:" << cmdStatus <<
 	      " Ret:" << cmdRet_ret);
-	return waitpidRet != 0;
+	return waitpidRet > 0;
     }
 
 
@@ -422,127 +397,106 @@ namespace storage
 	for (int streamIndex = 0; streamIndex < 2; streamIndex++)
 	{
 	    _outputLines[streamIndex].clear();
-	    _newLineSeen[streamIndex] = true;
+	    _partialLines[streamIndex].clear();
 	}
     }
 
 
     void
-    SystemCmd::checkOutput()
+    SystemCmd::sendStdin()
     {
-	y2deb("NewLine out:" << _newLineSeen[IDX_STDOUT] << " err:" << _newLineSeen[IDX_STDERR]);
-	if (_files[IDX_STDOUT])
-	    getUntilEOF(_files[IDX_STDOUT], _outputLines[IDX_STDOUT], _newLineSeen[IDX_STDOUT], false);
-	if (_files[IDX_STDERR])
-	    getUntilEOF(_files[IDX_STDERR], _outputLines[IDX_STDERR], _newLineSeen[IDX_STDERR], true);
-	y2deb("NewLine out:" << _newLineSeen[IDX_STDOUT] << " err:" << _newLineSeen[IDX_STDERR]);
+	if (_pfds[0].fd < 0)
+	    return;
+
+	while (!options.stdin_text.empty())
+	{
+	    ssize_t count = write(_pfds[0].fd, options.stdin_text.data(), options.stdin_text.size());
+	    if (count < 0)
+	    {
+		if (errno == EINTR)
+		    continue;
+
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+		    return;
+
+		SYSCALL_FAILED_NOTHROW("write to stdin failed");
+		break;
+	    }
+
+	    options.stdin_text.erase(0, count);
+	}
+
+	close(_pfds[0].fd);
+	_pfds[0].fd = -1; // ignore for poll() from now on
     }
 
 
     void
-    SystemCmd::sendStdin()
+    SystemCmd::readOutput(OutputStream stream)
     {
-        if ( ! _childStdin )
-            return;
-
-        if (!options.stdin_text.empty())
-        {
-            string::size_type count = 0;
-            string::size_type len   = options.stdin_text.size();
-            int result = 1;
-
-            while ( count < len && result > 0 )
-                result = fputc( options.stdin_text[ count++ ], _childStdin );
-
-            options.stdin_text.erase( 0, count );
-            // y2deb( count << " characters written; left over: \"" << _stdinText << "\"" );
-        }
-
-        if (options.stdin_text.empty())
-        {
-            fclose( _childStdin );
-            _childStdin = NULL;
-            _pfds[0].fd = -1; // ignore for poll() from now on
-        }
-    }
+	struct pollfd& pfd = _pfds[stream == IDX_STDOUT ? 1 : 2];
+	if (pfd.fd < 0)
+	    return;
 
+	vector<string>& lines = _outputLines[stream];
+	string& text = _partialLines[stream];
 
-#define BUF_LEN 256
+	size_t old_size = lines.size();
 
-    void
-    SystemCmd::getUntilEOF( FILE* file, vector<string>& lines,
-			    bool& newLineSeen_ret, bool isStderr ) const
-    {
-	size_t oldSize = lines.size();
-	char buffer[BUF_LEN];
-	int count;
-	int c;
-	string text;
-
-	clearerr( file );
-	count = 0;
-	c = EOF;
-	while ( (c=fgetc(file)) != EOF )
-	{
-	    buffer[count++] = c;
-	    if ( count==sizeof(buffer)-1 )
+	char buffer[64 * 1024];
+
+	while (true)
+	{
+	    ssize_t count = read(pfd.fd, buffer, sizeof(buffer));
+	    if (count < 0)
 	    {
-		buffer[count] = 0;
-		extractNewline( buffer, count, newLineSeen_ret, text, lines );
-		count = 0;
+		if (errno == EINTR)
+		    continue;
+
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+		    SYSCALL_FAILED_NOTHROW("read failed");
+
+		break;
 	    }
-	    c = EOF;
-	}
-	if ( count>0 )
-	{
-	    buffer[count] = 0;
-	    extractNewline( buffer, count, newLineSeen_ret, text, lines );
-	}
-	if ( text.length() > 0 )
-	{
-	    if ( newLineSeen_ret )
+
+	    if (count == 0)
 	    {
-		addLine( text, lines );
+		close(pfd.fd);
+		pfd.fd = -1; // ignore for poll() from now on
+		break;
 	    }
-	    else
+
+	    text.append(buffer, count);
+
+	    string::size_type pos1 = 0;
+	    string::size_type pos2;
+	    while ((pos2 = text.find('\n', pos1)) != string::npos)
 	    {
-		lines[lines.size()-1] += text;
+		addLine(text.substr(pos1, pos2 - pos1), lines);
+		pos1 = pos2 + 1;
 	    }
-	    newLineSeen_ret = false;
+	    text.erase(0, pos1);
 	}
-	else
-	{
-	    newLineSeen_ret = true;
-	}
-	y2deb("text:" << text << " NewLine:" << newLineSeen_ret);
-	if ( oldSize != lines.size() )
+
+	if (old_size != lines.size())
 	{
-	    y2mil("pid:" << _cmdPid << " added lines:" << lines.size() - oldSize << " stderr:" << isStderr);
+	    y2mil("pid:" << _cmdPid << " added lines:" << lines.size() - old_size << " stderr:" <<
+		  (stream == IDX_STDERR));
 	}
     }
 
 
     void
-    SystemCmd::extractNewline(const string& buffer, int count, bool& newLineSeen_ret,
-			      string& text, vector<string>& lines) const
+    SystemCmd::flushOutput()
     {
-	string::size_type index;
-
-	text += buffer;
-	while ( (index=text.find( '\n' )) != string::npos )
+	for (int streamIndex = 0; streamIndex < 2; streamIndex++)
 	{
-	    if ( !newLineSeen_ret )
+	    if (!_partialLines[streamIndex].empty())
 	    {
-		lines[lines.size()-1] += text.substr( 0, index );
+		addLine(_partialLines[streamIndex], _outputLines[streamIndex]);
+		_partialLines[streamIndex].clear();
 	    }
-	    else
-	    {
-		addLine( text.substr( 0, index ), lines );
-	    }
-	    text.erase( 0, index+1 );
-	    newLineSeen_ret = true;
 	}
-	y2deb("text: \"" << text << "\" newLineSeen: " << newLineSeen_ret);
     }
 
 
@@ -634,6 +588,27 @@ namespace storage
     }
 
 
+    vector<const char*>
+    SystemCmd::make_argv() const
+    {
+	vector<const char*> argv;
+
+	if (options.args.empty())
+	{
+	    argv = { SH_BIN, "-c", command().c_str() };
+	}
+	else
+	{
+	    for (const string& arg : options.args)
+		argv.push_back(arg.c_str());
+	}
+
+	argv.push_back(nullptr);
+
+	return argv;
+    }
+
+
     string
     SystemCmd::quote(const string& str)
     {
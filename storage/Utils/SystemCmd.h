@@ -43,7 +43,9 @@ namespace storage
 
 
     /**
-     * Class to invoke a shell command and capture its exit value and output.
+     * Class to invoke a command and capture its exit value and output. The
+     * command is either run by the shell or, if the arguments are given as
+     * a vector, executed directly.
      */
     class SystemCmd : private boost::noncopyable
     {
@@ -61,10 +63,26 @@ namespace storage
 		: command(command), throw_behaviour(throw_behaviour) {}
 
 	    /**
-	     * The command to be executed.
+	     * Constructor for running a command without the shell. The first
+	     * element of args is the program, the others are the arguments.
+	     * No quoting is needed.
+	     */
+	    Options(const vector<string>& args, ThrowBehaviour throw_behaviour = NoThrow)
+		: command(quote(args)), args(args), throw_behaviour(throw_behaviour) {}
+
+	    /**
+	     * The command to be executed by the shell. If args is not empty
+	     * this is only the quoted args, used for logging and as key for
+	     * the mockup.
 	     */
 	    string command;
 
+	    /**
+	     * If not empty the program and arguments executed directly
+	     * without the shell.
+	     */
+	    vector<string> args;
+
 	    /**
 	     * Should exceptions be thrown or not?
 	     */
@@ -167,15 +185,22 @@ namespace storage
 	void init();
 	void cleanup();
 	void invalidate();
-	void closeOpenFds() const;
 	int doExecute();
 	bool doWait(int& cmdRet_ret);
-	void checkOutput();
-        void sendStdin();
-	void getUntilEOF(FILE* file, vector<string>& lines,
-			 bool& newLineSeen_ret, bool isStderr) const;
-	void extractNewline(const string& buffer, int count, bool& newLineSeen_ret,
-			    string& text, vector<string>& lines) const;
+	void sendStdin();
+
+	/**
+	 * Reads the available output of the stream and splits it into
+	 * lines. Closes the stream on EOF.
+	 */
+	void readOutput(OutputStream stream);
+
+	/**
+	 * Adds the remaining text of the streams without a final newline as
+	 * the last line.
+	 */
+	void flushOutput();
+
 	void addLine(const string& text, vector<string>& lines) const;
 
 	void logOutput() const;
@@ -187,24 +212,22 @@ namespace storage
 
 	Options options;
 
-	FILE* _files[2];
-        FILE* _childStdin;
 	vector<string> _outputLines[2];
-	bool _newLineSeen[2];
+	string _partialLines[2];
 	int _cmdRet;
 	int _cmdPid;
 	struct pollfd _pfds[3];
 
 	/**
 	 * Constructs the environment for the child process.
-	 *
-	 * Must not be called after exec since allocating the memory
-	 * for the vector is not allowed then (in a multithreaded
-	 * program), see fork(2) and signal-safety(7). So simply call
-	 * it right before fork.
 	 */
 	vector<const char*> make_env() const;
 
+	/**
+	 * Constructs the argv for the child process.
+	 */
+	vector<const char*> make_argv() const;
+
     };
 
 
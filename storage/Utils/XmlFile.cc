@@ -22,9 +22,11 @@
 
 
 #include <string.h>
+#include <libxml/xmlsave.h>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/Format.h"
 
 
 namespace storage
@@ -73,6 +75,206 @@ namespace storage
     }
 
 
+    XmlFileReader::XmlFileReader(const string& filename)
+	: filename(filename), reader(xmlReaderForFile(filename.c_str(), NULL, XML_PARSE_NOBLANKS |
+						      XML_PARSE_NONET)),
+	  skip_subtree(false)
+    {
+	if (!reader)
+	    ST_THROW(Exception("failed to load xml document " + filename));
+    }
+
+
+    XmlFileReader::~XmlFileReader()
+    {
+	xmlFreeTextReader(reader);
+    }
+
+
+    bool
+    XmlFileReader::next_element()
+    {
+	while (true)
+	{
+	    int ret = skip_subtree ? xmlTextReaderNext(reader) : xmlTextReaderRead(reader);
+	    skip_subtree = false;
+
+	    if (ret < 0)
+		ST_THROW(Exception("failed to load xml document " + filename));
+
+	    if (ret == 0)
+		return false;
+
+	    if (xmlTextReaderNodeType(reader) == XML_READER_TYPE_ELEMENT)
+		return true;
+	}
+    }
+
+
+    int
+    XmlFileReader::depth() const
+    {
+	return xmlTextReaderDepth(reader);
+    }
+
+
+    string
+    XmlFileReader::name() const
+    {
+	return (const char*) xmlTextReaderConstName(reader);
+    }
+
+
+    const xmlNode*
+    XmlFileReader::expand()
+    {
+	const xmlNode* node = xmlTextReaderExpand(reader);
+	if (!node)
+	    ST_THROW(Exception("failed to load xml document " + filename));
+
+	skip_subtree = true;
+
+	return node->children;
+    }
+
+
+    namespace
+    {
+
+	/**
+	 * Serialise the node with the same settings as
+	 * XmlFile::save_to_file() as if it was at the given depth in the
+	 * document. For that the node is temporarily put below a chain of
+	 * dummy elements whose tags are removed from the output
+	 * afterwards.
+	 */
+	string
+	serialise_node(xmlNode* node, size_t depth)
+	{
+	    xmlNode* root = ::xmlNewNode(NULL, (const xmlChar*) "x");
+
+	    xmlNode* parent = root;
+	    for (size_t i = 1; i < depth; ++i)
+		parent = ::xmlNewChild(parent, NULL, (const xmlChar*) "x", NULL);
+
+	    xmlAddChild(parent, node);
+
+	    xmlBuffer* buffer = xmlBufferCreate();
+	    xmlSaveCtxt* ctxt = xmlSaveToBuffer(buffer, NULL, XML_SAVE_FORMAT | XML_SAVE_NO_DECL);
+	    xmlSaveTree(ctxt, root);
+	    xmlSaveClose(ctxt);
+
+	    string ret((const char*) xmlBufferContent(buffer), xmlBufferLength(buffer));
+
+	    xmlBufferFree(buffer);
+	    xmlFreeNode(root);
+
+	    // The indented opening tags of the dummy elements ("<x>\n") take
+	    // depth * (depth + 3) characters, the closing tags ("</x>\n",
+	    // without newline after the last one) depth * (depth + 4) - 1.
+
+	    const size_t head = depth * (depth + 3);
+	    const size_t tail = depth * (depth + 4) - 1;
+
+	    return ret.substr(head, ret.size() - head - tail);
+	}
+
+    }
+
+
+    XmlFileWriter::XmlFileWriter(const string& filename)
+	: filename(filename), fout(filename), start_tag_open(false)
+    {
+	if (!fout)
+	    ST_THROW(Exception(sformat("failed to write '%s'", filename)));
+
+	fout << "<?xml version=\"1.0\"?>\n";
+    }
+
+
+    XmlFileWriter::~XmlFileWriter()
+    {
+    }
+
+
+    void
+    XmlFileWriter::write_comment(const string& comment)
+    {
+	if (!elements.empty())
+	    ST_THROW(LogicException("comment after root element"));
+
+	fout << "<!--" << comment << "-->\n";
+    }
+
+
+    void
+    XmlFileWriter::start_element(const char* name)
+    {
+	finish_start_tag();
+
+	fout << string(2 * elements.size(), ' ') << '<' << name;
+
+	elements.push_back(name);
+	start_tag_open = true;
+    }
+
+
+    void
+    XmlFileWriter::end_element()
+    {
+	if (elements.empty())
+	    ST_THROW(LogicException("no element to end"));
+
+	if (start_tag_open)
+	{
+	    fout << "/>\n";
+	    start_tag_open = false;
+	}
+	else
+	{
+	    fout << string(2 * (elements.size() - 1), ' ') << "</" << elements.back() << ">\n";
+	}
+
+	elements.pop_back();
+    }
+
+
+    void
+    XmlFileWriter::write_node(xmlNode* node)
+    {
+	if (elements.empty())
+	    ST_THROW(LogicException("no element to write node into"));
+
+	finish_start_tag();
+
+	fout << serialise_node(node, elements.size());
+    }
+
+
+    void
+    XmlFileWriter::close()
+    {
+	if (!elements.empty())
+	    ST_THROW(LogicException("unended elements"));
+
+	fout.close();
+
+	if (!fout)
+	    ST_THROW(Exception(sformat("failed to write '%s'", filename)));
+    }
+
+
+    void
+    XmlFileWriter::finish_start_tag()
+    {
+	if (start_tag_open)
+	{
+	    fout << ">\n";
+	    start_tag_open = false;
+	}
+    }
+
+
     xmlNode*
     xmlNewNode(const char* name)
     {
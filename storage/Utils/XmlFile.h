@@ -26,10 +26,13 @@
 
 
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 #include <string>
 #include <vector>
 #include <sstream>
+#include <fstream>
 #include <optional>
+#include <charconv>
 #include <boost/noncopyable.hpp>
 
 #include "storage/Utils/AppUtil.h"
@@ -67,6 +70,105 @@ namespace storage
     };
 
 
+    /**
+     * Reads an XML file element by element using the xmlTextReader
+     * API. Only the subtree of the current element is kept in memory
+     * and only if expand() was called.
+     */
+    class XmlFileReader : private boost::noncopyable
+    {
+
+    public:
+
+	XmlFileReader(const string& filename);
+
+	~XmlFileReader();
+
+	/**
+	 * Move to the start of the next element. If expand() was called
+	 * for the current element its subtree is skipped. Returns false
+	 * at the end of the document.
+	 */
+	bool next_element();
+
+	/**
+	 * Depth of the current element. The root element has depth 0.
+	 */
+	int depth() const;
+
+	/**
+	 * Name of the current element.
+	 */
+	string name() const;
+
+	/**
+	 * Reads the subtree of the current element and returns its first
+	 * child like getChildNode(). The subtree is only valid until the
+	 * next call of next_element().
+	 */
+	const xmlNode* expand();
+
+    private:
+
+	const string filename;
+
+	xmlTextReader* reader;
+
+	bool skip_subtree;
+
+    };
+
+
+    /**
+     * Writes an XML file element by element. Only the node currently
+     * written is kept in memory. The output is identical to the output
+     * of XmlFile::save_to_file() for the same document.
+     */
+    class XmlFileWriter : private boost::noncopyable
+    {
+
+    public:
+
+	XmlFileWriter(const string& filename);
+
+	~XmlFileWriter();
+
+	/**
+	 * Write a comment. Only allowed before the root element.
+	 */
+	void write_comment(const string& comment);
+
+	void start_element(const char* name);
+	void end_element();
+
+	/**
+	 * Write the node including its subtree as child of the current
+	 * element. The node is freed afterwards.
+	 */
+	void write_node(xmlNode* node);
+
+	/**
+	 * Finish writing the file.
+	 *
+	 * @throw Exception
+	 */
+	void close();
+
+    private:
+
+	void finish_start_tag();
+
+	const string filename;
+
+	std::ofstream fout;
+
+	vector<string> elements;
+
+	bool start_tag_open;
+
+    };
+
+
     xmlNode* xmlNewNode(const char* name);
     xmlNode* xmlNewComment(const char* content);
 
@@ -92,6 +194,19 @@ namespace storage
 	if (!getChildValue(node, name, tmp))
 	    return false;
 
+	// std::from_chars is much faster than a stream. The stream is
+	// still used for anything from_chars does not accept so that
+	// the result stays the same, e.g. a negative value for an
+	// unsigned type.
+
+	if constexpr (sizeof(Type) > 1)
+	{
+	    const char* last = tmp.data() + tmp.size();
+	    std::from_chars_result result = std::from_chars(tmp.data(), last, value);
+	    if (result.ec == std::errc() && result.ptr == last)
+		return true;
+	}
+
 	std::istringstream istr(tmp);
 	classic(istr);
 	istr >> value;
@@ -0,0 +1,58 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "testsuite/CompoundAction/Fixture.h"
+
+using namespace storage;
+
+
+BOOST_FIXTURE_TEST_SUITE(lazy_generation, test::CompoundActionFixture)
+
+
+BOOST_AUTO_TEST_CASE(test_lazy_generation)
+{
+    initialize_staging_with_three_partitions();
+
+    const Partition* sda4 = sda_gpt->create_partition("/dev/sda4", Region(1005 * 2048, 500 * 2048, 512),
+						      PartitionType::PRIMARY);
+
+    Actiongraph actiongraph(*storage, storage->get_system(), staging);
+
+    // compound actions are generated on demand
+
+    vector<const CompoundAction*> compound_actions = actiongraph.get_compound_actions(sda2);
+
+    BOOST_REQUIRE_EQUAL(compound_actions.size(), 1);
+    BOOST_CHECK_EQUAL(compound_actions[0]->get_target_device(), sda2);
+    BOOST_CHECK_EQUAL(compound_actions[0]->sentence(), "Create partition /dev/sda2 (500.00 MiB) as Linux");
+
+    BOOST_CHECK_EQUAL(actiongraph.get_compound_actions(sda).size(), 1);
+    BOOST_CHECK_EQUAL(actiongraph.get_compound_actions(sda4).size(), 1);
+
+    BOOST_CHECK_EQUAL(CompoundAction::find_by_target_device(&actiongraph, sda2), compound_actions[0]);
+
+    // same result as the complete list
+
+    BOOST_CHECK_EQUAL(actiongraph.get_compound_actions().size(), 5);
+    BOOST_CHECK_EQUAL(find_compound_action_by_target(&actiongraph, sda2), compound_actions[0]);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_no_compound_actions)
+{
+    initialize_staging_with_three_partitions();
+
+    copy_staging_to_probed();
+
+    Actiongraph actiongraph(*storage, storage->get_system(), staging);
+    actiongraph.generate_compound_actions();
+
+    BOOST_CHECK(actiongraph.get_compound_actions(sda1).empty());
+
+    BOOST_CHECK_THROW(CompoundAction::find_by_target_device(&actiongraph, sda1), DeviceNotFound);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
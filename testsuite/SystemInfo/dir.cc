@@ -6,6 +6,8 @@
 #include <boost/algorithm/string.hpp>
 
 #include "storage/SystemInfo/DevAndSys.h"
+#include "storage/SystemInfo/CmdStat.h"
+#include "storage/Utils/FileUtils.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageDefines.h"
@@ -61,3 +63,45 @@ BOOST_AUTO_TEST_CASE(error1)
 
     BOOST_CHECK_THROW(Dir dir(path), Exception);
 }
+
+
+BOOST_AUTO_TEST_CASE(native1)
+{
+    Mockup::set_mode(Mockup::Mode::RECORD);
+
+    TmpDir tmp_dir("libstorage-XXXXXX");
+
+    const string path = tmp_dir.get_fullname();
+    const string a = path + "/a";
+    const string b = path + "/.b";
+
+    BOOST_REQUIRE(mkdir(a.c_str(), 0700) == 0);
+    BOOST_REQUIRE(mkdir(b.c_str(), 0700) == 0);
+
+    Dir dir(path);
+
+    vector<string> entries(dir.begin(), dir.end());
+    BOOST_CHECK_EQUAL(boost::join(entries, " "), "a");
+
+    // the result is recorded as if 'ls' was run
+
+    const Mockup::Command& command = Mockup::get_command(LS_BIN " -1 --sort=none " + quote(path));
+    BOOST_CHECK_EQUAL(boost::join(command.stdout, " "), "a");
+    BOOST_CHECK_EQUAL(command.exit_code, 0);
+
+    CmdStat cmd_stat(a);
+    BOOST_CHECK(cmd_stat.is_dir());
+
+    // the result is recorded as if 'stat' was run
+
+    const Mockup::Command& command2 = Mockup::get_command(STAT_BIN " --format '%f' " + quote(a));
+    BOOST_CHECK_EQUAL(boost::join(command2.stdout, " "), "41c0");
+
+    BOOST_REQUIRE(rmdir(a.c_str()) == 0);
+    BOOST_REQUIRE(rmdir(b.c_str()) == 0);
+
+    BOOST_CHECK_THROW(Dir dir(a), Exception);
+    BOOST_CHECK(!CmdStat(a).is_dir());
+
+    Mockup::set_mode(Mockup::Mode::NONE);
+}
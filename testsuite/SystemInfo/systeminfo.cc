@@ -8,6 +8,7 @@
 #include "storage/SystemInfo/SystemInfoImpl.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/FileUtils.h"
 
 
 using namespace std;
@@ -33,3 +34,54 @@ BOOST_AUTO_TEST_CASE(exception1)
 
     BOOST_CHECK_THROW({ system_info.getParted("/dev/sda"); }, ParseException);
 }
+
+
+BOOST_AUTO_TEST_CASE(prefetch1)
+{
+    // Check that prefetch fills the caches, including exceptions, when
+    // using several threads.
+
+    Mockup::set_mode(Mockup::Mode::NONE);
+
+    TmpDir tmp_dir("libstorage-XXXXXX");
+
+    vector<string> paths;
+
+    for (int i = 0; i < 20; ++i)
+    {
+	string path = tmp_dir.get_fullname() + "/" + to_string(i);
+	BOOST_REQUIRE(mkdir(path.c_str(), 0700) == 0);
+	paths.push_back(path);
+    }
+
+    string missing = tmp_dir.get_fullname() + "/missing";
+
+    SystemInfo::Impl system_info;
+
+    vector<SystemInfo::Impl::prefetch_function_t> prefetch_functions;
+
+    for (const string& path : paths)
+	prefetch_functions.push_back([path](SystemInfo::Impl& system_info) { system_info.getDir(path); });
+
+    prefetch_functions.push_back([missing](SystemInfo::Impl& system_info) { system_info.getDir(missing); });
+
+    system_info.prefetch(prefetch_functions);
+
+    // Create entries after the prefetch. They must not show up.
+
+    for (const string& path : paths)
+	BOOST_REQUIRE(mkdir((path + "/a").c_str(), 0700) == 0);
+
+    BOOST_REQUIRE(mkdir(missing.c_str(), 0700) == 0);
+
+    for (const string& path : paths)
+    {
+	BOOST_CHECK(system_info.getDir(path).begin() == system_info.getDir(path).end());
+	BOOST_REQUIRE(rmdir((path + "/a").c_str()) == 0);
+	BOOST_REQUIRE(rmdir(path.c_str()) == 0);
+    }
+
+    BOOST_CHECK_THROW(system_info.getDir(missing), Exception);
+
+    BOOST_REQUIRE(rmdir(missing.c_str()) == 0);
+}
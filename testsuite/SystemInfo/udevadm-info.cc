@@ -203,3 +203,114 @@ BOOST_AUTO_TEST_CASE(parse2)
 
     check("/dev/sda1", input, output);
 }
+
+
+void
+check_export_db(const vector<string>& files, const vector<string>& output)
+{
+    const vector<string> input = {
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0",
+	"E: DEVPATH=/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0",
+	"E: SUBSYSTEM=scsi",
+	"",
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda",
+	"N: sda",
+	"S: disk/by-id/wwn-0x50014ee203733bb5",
+	"S: disk/by-path/pci-0000:00:1f.2-ata-1",
+	"E: DEVNAME=/dev/sda",
+	"E: DEVTYPE=disk",
+	"E: MAJOR=8",
+	"E: MINOR=0",
+	"E: SUBSYSTEM=block",
+	"",
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1",
+	"N: sda1",
+	"S: disk/by-id/wwn-0x50014ee203733bb5-part1",
+	"S: disk/by-partuuid/8a1b2c3d-01",
+	"S: disk/by-uuid/1234",
+	"E: DEVNAME=/dev/sda1",
+	"E: DEVTYPE=partition",
+	"E: MAJOR=8",
+	"E: MINOR=1",
+	"E: SUBSYSTEM=block",
+	"",
+	"P: /devices/virtual/block/dm-0",
+	"N: dm-0",
+	"S: disk/by-uuid/1234",
+	"S: mapper/cr_test",
+	"E: DEVNAME=/dev/dm-0",
+	"E: DEVTYPE=disk",
+	"E: MAJOR=254",
+	"E: MINOR=0",
+	"E: SUBSYSTEM=block"
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(UDEVADM_BIN_SETTLE, {});
+    Mockup::set_command(UDEVADM_BIN " info --export-db", input);
+
+    CmdUdevadmExportDb cmd_udevadm_export_db;
+
+    BOOST_CHECK_EQUAL(cmd_udevadm_export_db.size(), 3);
+
+    string lhs;
+
+    for (const string& file : files)
+    {
+	CmdUdevadmInfo cmd_udevadm_info(file, &cmd_udevadm_export_db);
+
+	ostringstream parsed;
+	parsed.setf(std::ios::boolalpha);
+	parsed << cmd_udevadm_info;
+
+	lhs += parsed.str();
+    }
+
+    string rhs = boost::join(output, "\n") + "\n";
+
+    BOOST_CHECK_EQUAL(lhs, rhs);
+}
+
+
+BOOST_AUTO_TEST_CASE(export_db1)
+{
+    vector<string> files = {
+	"/dev/sda",
+	"/dev/disk/by-partuuid/8a1b2c3d-01",
+	"/dev/block/254:0",
+	"/sys/devices/virtual/block/dm-0"
+    };
+
+    vector<string> output = {
+	"file:/dev/sda path:/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda name:sda majorminor:8:0 device-type:disk by-path-links:<pci-0000:00:1f.2-ata-1> by-id-links:<wwn-0x50014ee203733bb5>",
+	"file:/dev/disk/by-partuuid/8a1b2c3d-01 path:/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1 name:sda1 majorminor:8:1 device-type:partition by-id-links:<wwn-0x50014ee203733bb5-part1> by-part-uuid-links:<8a1b2c3d-01>",
+	"file:/dev/block/254:0 path:/devices/virtual/block/dm-0 name:dm-0 majorminor:254:0 device-type:disk",
+	"file:/sys/devices/virtual/block/dm-0 path:/devices/virtual/block/dm-0 name:dm-0 majorminor:254:0 device-type:disk"
+    };
+
+    check_export_db(files, output);
+}
+
+
+BOOST_AUTO_TEST_CASE(export_db2)
+{
+    // The link is claimed by two devices so 'udevadm info' must be used.
+
+    Mockup::set_command(UDEVADM_BIN " info " + quote("/dev/disk/by-uuid/1234"), vector<string>({
+	"P: /devices/virtual/block/dm-0",
+	"N: dm-0",
+	"E: MAJOR=254",
+	"E: MINOR=0",
+	"E: DEVTYPE=disk"
+    }));
+
+    vector<string> files = {
+	"/dev/disk/by-uuid/1234"
+    };
+
+    vector<string> output = {
+	"file:/dev/disk/by-uuid/1234 path:/devices/virtual/block/dm-0 name:dm-0 majorminor:254:0 device-type:disk"
+    };
+
+    check_export_db(files, output);
+}
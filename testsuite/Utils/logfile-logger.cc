@@ -0,0 +1,71 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <stdio.h>
+#include <fstream>
+#include <regex>
+
+#include "storage/Utils/Logger.h"
+#include "storage/Utils/FileUtils.h"
+
+using namespace std;
+using namespace storage;
+
+
+static vector<string>
+read_lines(const string& filename)
+{
+    vector<string> lines;
+
+    ifstream s(filename);
+    string line;
+    while (getline(s, line))
+	lines.push_back(line);
+
+    return lines;
+}
+
+
+BOOST_AUTO_TEST_CASE(write_and_rotate)
+{
+    TmpDir tmp_dir("logfile-logger-XXXXXX");
+
+    const string filename = tmp_dir.get_fullname() + "/libstorage.log";
+
+    Logger* logger = get_logfile_logger(filename);
+
+    // lines with level ERROR are written immediately together with all
+    // buffered lines
+
+    logger->write(LogLevel::MILESTONE, "libstorage", "Foo.cc", 42, "foo", "hello");
+    logger->write(LogLevel::ERROR, "libstorage", "Bar.cc", 7, "bar", "world");
+
+    vector<string> lines = read_lines(filename);
+
+    BOOST_REQUIRE_EQUAL(lines.size(), 2);
+
+    const regex rx("[0-9]{4}-[0-9]{2}-[0-9]{2} [0-9]{2}:[0-9]{2}:[0-9]{2} [A-Z]+ (.*)");
+
+    smatch match;
+
+    BOOST_REQUIRE(regex_match(lines[0], match, rx));
+    BOOST_CHECK_EQUAL(match[1], "<1> [libstorage] Foo.cc(foo):42 hello");
+
+    BOOST_REQUIRE(regex_match(lines[1], match, rx));
+    BOOST_CHECK_EQUAL(match[1], "<3> [libstorage] Bar.cc(bar):7 world");
+
+    // after the log file was renamed a new log file is created
+
+    BOOST_REQUIRE_EQUAL(rename(filename.c_str(), (filename + ".1").c_str()), 0);
+
+    logger->write(LogLevel::ERROR, "libstorage", "Baz.cc", 1, "baz", "again");
+
+    BOOST_CHECK_EQUAL(read_lines(filename).size(), 1);
+    BOOST_CHECK_EQUAL(read_lines(filename + ".1").size(), 2);
+
+    unlink(filename.c_str());
+    unlink((filename + ".1").c_str());
+}
@@ -114,6 +114,35 @@ BOOST_AUTO_TEST_CASE(retcode_42)
 }
 
 
+BOOST_AUTO_TEST_CASE(args)
+{
+    vector<string> stdout = {
+	"stdout #1: hello world",
+	"stdout #2: $HOME"
+    };
+
+    SystemCmd cmd(SystemCmd::Options(vector<string>{ "../helpers/echoargs", "hello world", "$HOME" }));
+
+    BOOST_CHECK_EQUAL(cmd.command(), "'../helpers/echoargs' 'hello world' '$HOME'");
+    BOOST_CHECK_EQUAL(join(cmd.stdout()), join(stdout));
+    BOOST_CHECK(cmd.stderr().empty());
+    BOOST_CHECK(cmd.retcode() == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(args_non_existent)
+{
+    BOOST_CHECK_NO_THROW({
+	SystemCmd cmd(SystemCmd::Options(vector<string>{ "/bin/wrglbrmpf" }, SystemCmd::ThrowBehaviour::NoThrow));
+	BOOST_CHECK_EQUAL(cmd.retcode(), 127);
+    });
+
+    BOOST_CHECK_THROW({
+	SystemCmd cmd(SystemCmd::Options(vector<string>{ "/bin/wrglbrmpf" }, SystemCmd::ThrowBehaviour::DoThrow));
+    }, CommandNotFoundException);
+}
+
+
 BOOST_AUTO_TEST_CASE(non_existent_no_throw)
 {
     BOOST_CHECK_NO_THROW({
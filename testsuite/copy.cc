@@ -59,3 +59,39 @@ BOOST_AUTO_TEST_CASE(copy)
 
     devicegraph_copy->check();
 }
+
+
+BOOST_AUTO_TEST_CASE(copy_is_independent)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb");
+
+    Gpt* gpt = Gpt::create(devicegraph);
+    User::create(devicegraph, sda, gpt);
+
+    Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
+
+    devicegraph_copy->check();
+
+    std::vector<Disk*> disks = Disk::get_all(devicegraph_copy);
+    BOOST_REQUIRE_EQUAL(disks.size(), 2);
+    BOOST_CHECK_EQUAL(disks[0]->get_sid(), sda->get_sid());
+    BOOST_CHECK_EQUAL(disks[1]->get_sid(), sdb->get_sid());
+
+    BlkDevice* sda_copy = BlkDevice::find_by_name(devicegraph_copy, "/dev/sda");
+    BOOST_CHECK(sda_copy != sda);
+    BOOST_CHECK_EQUAL(sda_copy->get_devicegraph(), devicegraph_copy);
+    BOOST_CHECK(sda_copy->has_children());
+
+    devicegraph_copy->remove_device(sda_copy->get_children()[0]);
+
+    BOOST_CHECK(!sda_copy->has_children());
+    BOOST_CHECK(sda->has_children());
+    BOOST_CHECK_EQUAL(devicegraph->num_holders(), 1);
+}
@@ -0,0 +1,23 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/Logger.h"
+#include "testsuite/helpers/TsCmp.h"
+
+
+using namespace storage;
+
+
+// Check that the partition id and flags are set by the same parted call
+// that creates the partition. Only not possible for flags without
+// state, here diag.
+
+BOOST_AUTO_TEST_CASE(actions)
+{
+    set_logger(get_stdout_logger());
+
+    TsCmpActiongraph cmp("create1", true);
+    BOOST_CHECK_MESSAGE(cmp.ok(), cmp);
+}
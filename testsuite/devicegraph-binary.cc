@@ -0,0 +1,117 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <unistd.h>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Exception.h"
+#include "storage/Utils/FileUtils.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+static string
+read_file(const string& filename)
+{
+    ifstream in(filename, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+
+static void
+write_file(const string& filename, const string& content)
+{
+    ofstream out(filename, ios::binary);
+    out << content;
+}
+
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("test");
+
+    Disk* disk = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* gpt = disk->create_partition_table(PtType::GPT);
+
+    Partition* partition = gpt->create_partition("/dev/sda1", Region(2048, 100000, 512),
+						 PartitionType::PRIMARY);
+
+    BlkFilesystem* blk_filesystem = partition->create_blk_filesystem(FsType::EXT4);
+    blk_filesystem->set_label("h\xc3\xa4user & <g\xc3\xa4rten>");
+    blk_filesystem->create_mount_point("/test");
+
+    TmpDir tmp_dir("devicegraph-binary-XXXXXX");
+
+    const string xml_filename = tmp_dir.get_fullname() + "/devicegraph.xml";
+    const string binary_filename = tmp_dir.get_fullname() + "/devicegraph.bin";
+
+    devicegraph->save_binary(binary_filename);
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    loaded->load(binary_filename);
+
+    BOOST_CHECK(*loaded == *devicegraph);
+
+    // XML -> binary -> XML is lossless
+
+    devicegraph->save(xml_filename);
+    const string xml = read_file(xml_filename);
+
+    loaded->load(xml_filename);
+    loaded->save_binary(binary_filename);
+    loaded->load(binary_filename);
+    loaded->save(xml_filename);
+
+    // ignore the comment with the date
+    BOOST_CHECK_EQUAL(read_file(xml_filename).substr(xml.find("-->")), xml.substr(xml.find("-->")));
+
+    unlink(xml_filename.c_str());
+    unlink(binary_filename.c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE(incompatible)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("test");
+    Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    TmpDir tmp_dir("devicegraph-binary-XXXXXX");
+
+    const string filename = tmp_dir.get_fullname() + "/devicegraph.bin";
+
+    devicegraph->save_binary(filename);
+    const string content = read_file(filename);
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+
+    // newer version
+
+    write_file(filename, content.substr(0, 8) + string("\x02\x00\x00\x00", 4) + content.substr(12));
+    BOOST_CHECK_THROW(loaded->load(filename), Exception);
+
+    // truncated
+
+    write_file(filename, content.substr(0, content.size() - 5));
+    BOOST_CHECK_THROW(loaded->load(filename), Exception);
+
+    unlink(filename.c_str());
+}
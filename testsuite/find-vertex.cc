@@ -93,3 +93,99 @@ BOOST_AUTO_TEST_CASE(find_vertex)
 
     BOOST_CHECK_THROW(BlkDevice::find_by_any_name(system, "/dev/does-not-exist", system_info), DeviceNotFound);
 }
+
+
+BOOST_AUTO_TEST_CASE(find_vertex_and_edges_after_modifications)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda");
+    Disk* sdb = Disk::create(staging, "/dev/sdb");
+
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 1000000, 512), PartitionType::PRIMARY);
+
+    BOOST_CHECK(staging->device_exists(sda1->get_sid()));
+    BOOST_CHECK(staging->holder_exists(sda->get_sid(), gpt->get_sid()));
+    BOOST_CHECK_EQUAL(staging->find_holders(gpt->get_sid(), sda1->get_sid()).size(), 1);
+
+    // moving the holder must update the lookup by sids
+
+    Holder* holder = staging->find_holder(sda->get_sid(), gpt->get_sid());
+    holder->set_source(sdb);
+
+    BOOST_CHECK(!staging->holder_exists(sda->get_sid(), gpt->get_sid()));
+    BOOST_CHECK(staging->holder_exists(sdb->get_sid(), gpt->get_sid()));
+
+    // a copy must have working lookups
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_EQUAL(copy->find_device(sda1->get_sid())->get_sid(), sda1->get_sid());
+    BOOST_CHECK(copy->holder_exists(sdb->get_sid(), gpt->get_sid()));
+
+    // removing a device must also remove its holders from the lookup
+
+    sid_t gpt_sid = gpt->get_sid();
+    sid_t sda1_sid = sda1->get_sid();
+
+    staging->remove_device(gpt);
+
+    BOOST_CHECK(!staging->device_exists(gpt_sid));
+    BOOST_CHECK_THROW(staging->find_device(gpt_sid), DeviceNotFoundBySid);
+    BOOST_CHECK(!staging->holder_exists(sdb->get_sid(), gpt_sid));
+    BOOST_CHECK(!staging->holder_exists(gpt_sid, sda1_sid));
+    BOOST_CHECK(staging->device_exists(sda1_sid));
+
+    BOOST_CHECK(copy->device_exists(gpt_sid));
+
+    staging->clear();
+
+    BOOST_CHECK(!staging->device_exists(sda1_sid));
+    BOOST_CHECK_EQUAL(copy->num_devices(), 4);
+}
+
+
+BOOST_AUTO_TEST_CASE(find_by_name_after_rename)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda");
+    Disk* sdb = Disk::create(staging, "/dev/sdb");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(staging, "/dev/sda"), sda);
+
+    sda->get_impl().set_name("/dev/sdc");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(staging, "/dev/sdc"), sda);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(staging, "/dev/sda"), DeviceNotFound);
+
+    // the order of devices of a type must not change
+
+    Gpt* gpt = to_gpt(sdb->create_partition_table(PtType::GPT));
+    gpt->create_partition("/dev/sdb1", Region(2048, 1000000, 512), PartitionType::PRIMARY);
+
+    vector<Disk*> disks = Disk::get_all(staging);
+    BOOST_REQUIRE_EQUAL(disks.size(), 2);
+    BOOST_CHECK_EQUAL(disks[0], sda);
+    BOOST_CHECK_EQUAL(disks[1], sdb);
+
+    vector<BlkDevice*> blk_devices = BlkDevice::get_all(staging);
+    BOOST_REQUIRE_EQUAL(blk_devices.size(), 3);
+    BOOST_CHECK_EQUAL(blk_devices[0]->get_name(), "/dev/sdc");
+    BOOST_CHECK_EQUAL(blk_devices[1]->get_name(), "/dev/sdb");
+    BOOST_CHECK_EQUAL(blk_devices[2]->get_name(), "/dev/sdb1");
+
+    staging->remove_device(sda);
+
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(staging, "/dev/sdc"), DeviceNotFound);
+    BOOST_CHECK_EQUAL(Disk::get_all(staging).size(), 1);
+}
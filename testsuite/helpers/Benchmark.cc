@@ -0,0 +1,86 @@
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Utils/Stopwatch.h"
+
+#include "testsuite/helpers/Benchmark.h"
+
+
+namespace storage
+{
+
+    Benchmark::Benchmark(const string& name, const vector<unsigned int>& default_sizes)
+	: name(name), sizes(default_sizes)
+    {
+	const char* p = getenv("LIBSTORAGE_BENCHMARK_SIZES");
+	if (p)
+	{
+	    vector<string> tmp;
+	    boost::split(tmp, p, boost::is_any_of(","), boost::token_compress_on);
+
+	    sizes.clear();
+
+	    for (const string& s : tmp)
+	    {
+		if (!s.empty())
+		    sizes.push_back(stoul(s));
+	    }
+	}
+    }
+
+
+    Benchmark::~Benchmark()
+    {
+	ofstream out(name + "-benchmark.json");
+	write_json(out);
+    }
+
+
+    double
+    Benchmark::measure(const string& test, unsigned int size, const std::function<void()>& func)
+    {
+	Stopwatch stopwatch;
+
+	func();
+
+	double seconds = stopwatch.read();
+
+	add(test, size, seconds);
+
+	return seconds;
+    }
+
+
+    void
+    Benchmark::add(const string& test, unsigned int size, double seconds)
+    {
+	results.push_back({ test, size, seconds });
+
+	cout << name << " " << test << " size:" << size << " " << seconds << " s" << endl;
+    }
+
+
+    void
+    Benchmark::write_json(std::ostream& out) const
+    {
+	out << "{\n"
+	    << "  \"benchmark\": \"" << name << "\",\n"
+	    << "  \"results\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+	    const Result& result = results[i];
+
+	    out << (i == 0 ? "\n" : ",\n")
+		<< "    { \"test\": \"" << result.test << "\", \"size\": " << result.size
+		<< ", \"seconds\": " << result.seconds << " }";
+	}
+
+	out << "\n  ]\n"
+	    << "}\n";
+    }
+
+}
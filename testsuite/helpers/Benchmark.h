@@ -0,0 +1,68 @@
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    /*
+     * Simple benchmark harness for the performance testsuite, e.g.:
+     *
+     * Benchmark benchmark("devicegraph");
+     *
+     * for (unsigned int size : benchmark.get_sizes())
+     *     benchmark.measure("create", size, [size]() { ... });
+     *
+     * The sizes can be overridden with the environment variable
+     * LIBSTORAGE_BENCHMARK_SIZES, e.g. "100,1000,10000". The results are
+     * written as JSON to "<name>-benchmark.json" when the object is
+     * destroyed.
+     */
+
+
+    class Benchmark
+    {
+    public:
+
+	Benchmark(const string& name, const vector<unsigned int>& default_sizes = { 100, 1000 });
+	~Benchmark();
+
+	const vector<unsigned int>& get_sizes() const { return sizes; }
+
+	/**
+	 * Runs the function and records the elapsed time in seconds, which
+	 * is also returned.
+	 */
+	double measure(const string& test, unsigned int size, const std::function<void()>& func);
+
+	/**
+	 * Records a time measured by the caller.
+	 */
+	void add(const string& test, unsigned int size, double seconds);
+
+	void write_json(std::ostream& out) const;
+
+    private:
+
+	struct Result
+	{
+	    string test;
+	    unsigned int size;
+	    double seconds;
+	};
+
+	const string name;
+
+	vector<unsigned int> sizes;
+
+	vector<Result> results;
+
+    };
+
+}
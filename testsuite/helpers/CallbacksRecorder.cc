@@ -42,6 +42,22 @@ namespace storage
     }
 
 
+    void
+    CommitCallbacksRecorder::message(const string& message) const
+    {
+	messages.push_back("message: '" + message + "'");
+    }
+
+
+    bool
+    CommitCallbacksRecorder::error(const string& message, const string& what) const
+    {
+	messages.push_back("error: message = '" + message + "', what = '" + what + "'");
+
+	return true;
+    }
+
+
     void
     CheckCallbacksRecorder::error(const string& message) const
     {
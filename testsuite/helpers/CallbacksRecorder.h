@@ -33,6 +33,21 @@ namespace storage
     };
 
 
+    class CommitCallbacksRecorder : public CommitCallbacks
+    {
+    public:
+
+	CommitCallbacksRecorder(vector<string>& messages) : messages(messages) { messages.clear(); }
+
+	virtual void message(const std::string& message) const override;
+
+	virtual bool error(const string& message, const std::string& what) const override;
+
+	vector<string>& messages;
+
+    };
+
+
     class CheckCallbacksRecorder : public CheckCallbacks
     {
     public:
@@ -0,0 +1,82 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <unistd.h>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/Exception.h"
+#include "storage/Utils/FileUtils.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+static void
+write_file(const string& filename, const string& content)
+{
+    ofstream out(filename);
+    out << content;
+}
+
+
+BOOST_AUTO_TEST_CASE(load)
+{
+    TmpDir tmp_dir("mockup-XXXXXX");
+
+    const string filename = tmp_dir.get_fullname() + "/mockup.xml";
+
+    write_file(filename, "<?xml version=\"1.0\"?>\n"
+	       "<Mockup>\n"
+	       "  <Commands>\n"
+	       "    <Command>\n"
+	       "      <name>/usr/bin/udevadm info '/dev/sda'</name>\n"
+	       "      <name>/usr/bin/udevadm info '/dev/block/8:0'</name>\n"
+	       "      <stdout>N: sda</stdout>\n"
+	       "    </Command>\n"
+	       "    <Command>\n"
+	       "      <!-- comment -->\n"
+	       "      <stdout>N: sda</stdout>\n"
+	       "      <name>/usr/bin/udevadm info '/dev/disk/by-id/ata-disk'</name>\n"
+	       "    </Command>\n"
+	       "    <Command>\n"
+	       "      <name>/usr/bin/udevadm info '/dev/sdb'</name>\n"
+	       "      <stdout>N: sdb</stdout>\n"
+	       "      <stderr>warning &amp; &lt;more&gt;</stderr>\n"
+	       "      <exit-code>1</exit-code>\n"
+	       "    </Command>\n"
+	       "  </Commands>\n"
+	       "  <Files>\n"
+	       "    <File>\n"
+	       "      <name>/proc/mounts</name>\n"
+	       "      <content>/dev/sda1 / ext4 rw 0 0</content>\n"
+	       "    </File>\n"
+	       "  </Files>\n"
+	       "</Mockup>\n");
+
+    Mockup::load(filename);
+
+    const Mockup::Command& sda = Mockup::get_command("/usr/bin/udevadm info '/dev/sda'");
+    BOOST_CHECK(sda.stdout == vector<string>({ "N: sda" }));
+
+    // identical outputs share the entry
+
+    BOOST_CHECK_EQUAL(&Mockup::get_command("/usr/bin/udevadm info '/dev/block/8:0'"), &sda);
+    BOOST_CHECK_EQUAL(&Mockup::get_command("/usr/bin/udevadm info '/dev/disk/by-id/ata-disk'"), &sda);
+
+    const Mockup::Command& sdb = Mockup::get_command("/usr/bin/udevadm info '/dev/sdb'");
+    BOOST_CHECK(sdb.stdout == vector<string>({ "N: sdb" }));
+    BOOST_CHECK(sdb.stderr == vector<string>({ "warning & <more>" }));
+    BOOST_CHECK_EQUAL(sdb.exit_code, 1);
+
+    BOOST_CHECK(Mockup::get_file("/proc/mounts").content == vector<string>({ "/dev/sda1 / ext4 rw 0 0" }));
+
+    // loading again finds the same names
+
+    BOOST_CHECK_THROW(Mockup::load(filename), Exception);
+
+    unlink(filename.c_str());
+}
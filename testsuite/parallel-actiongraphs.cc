@@ -0,0 +1,119 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Actiongraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Creates a storage object with four disks with GPTs in the system
+ * devicegraph and the given number of candidate devicegraphs. Candidate i
+ * has i + 1 partitions with filesystems on every disk, the filesystem
+ * type varies with i.
+ */
+vector<Devicegraph*>
+create_candidates(Storage& storage, unsigned int num_candidates)
+{
+    Devicegraph* staging = storage.get_staging();
+
+    for (const string name : { "/dev/sda", "/dev/sdb", "/dev/sdc", "/dev/sdd" })
+    {
+	Disk* disk = Disk::create(staging, name, Region(0, 1000000, 512));
+	disk->create_partition_table(PtType::GPT);
+    }
+
+    storage.remove_devicegraph("system");
+    storage.copy_devicegraph("staging", "system");
+
+    const vector<FsType> fs_types = { FsType::EXT4, FsType::XFS, FsType::BTRFS, FsType::SWAP };
+
+    vector<Devicegraph*> candidates;
+
+    for (unsigned int i = 0; i < num_candidates; ++i)
+    {
+	Devicegraph* candidate = storage.copy_devicegraph("system", "candidate-" + to_string(i));
+
+	for (Disk* disk : Disk::get_all(candidate))
+	{
+	    PartitionTable* gpt = disk->get_partition_table();
+
+	    for (unsigned int j = 1; j <= i + 1; ++j)
+	    {
+		Partition* partition = gpt->create_partition(disk->get_name() + to_string(j),
+							     Region(2048 + (j - 1) * 100000, 100000, 512),
+							     PartitionType::PRIMARY);
+		partition->create_blk_filesystem(fs_types[i % fs_types.size()]);
+	    }
+	}
+
+	candidates.push_back(candidate);
+    }
+
+    return candidates;
+}
+
+
+BOOST_AUTO_TEST_CASE(same_as_serial)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    vector<Devicegraph*> candidates = create_candidates(storage, 6);
+
+    vector<const Actiongraph*> actiongraphs = storage.calculate_actiongraphs(candidates);
+
+    BOOST_REQUIRE_EQUAL(actiongraphs.size(), candidates.size());
+
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+	Actiongraph serial(storage, storage.get_system(), candidates[i]);
+	serial.generate_compound_actions();
+
+	BOOST_CHECK_EQUAL(actiongraphs[i]->get_devicegraph(RHS), candidates[i]);
+	BOOST_CHECK_EQUAL(actiongraphs[i]->num_actions(), serial.num_actions());
+	BOOST_CHECK_EQUAL(actiongraphs[i]->used_features(), serial.used_features());
+	BOOST_CHECK_EQUAL(actiongraphs[i]->get_compound_actions().size(),
+			  serial.get_compound_actions().size());
+
+	vector<string> parallel_actions = actiongraphs[i]->get_commit_actions_as_strings();
+	vector<string> serial_actions = serial.get_commit_actions_as_strings();
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(parallel_actions.begin(), parallel_actions.end(),
+				      serial_actions.begin(), serial_actions.end());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(invalid_candidates)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    vector<Devicegraph*> candidates = create_candidates(storage, 2);
+
+    BOOST_CHECK_THROW(storage.calculate_actiongraphs({ candidates[0], candidates[1], candidates[0] }),
+		      Exception);
+
+    BOOST_CHECK_THROW(storage.calculate_actiongraphs({ candidates[0], storage.get_system() }),
+		      Exception);
+
+    BOOST_CHECK(storage.calculate_actiongraphs({}).empty());
+}
@@ -0,0 +1,85 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/CommitOptions.h"
+#include "storage/Utils/Mockup.h"
+
+#include "testsuite/helpers/CallbacksRecorder.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Commits the creation of partitions and filesystems on several disks and
+ * records the callbacks. Since the mockup has no commands every action
+ * fails.
+ */
+vector<string>
+commit(unsigned int parallel_actions)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    for (const string name : { "/dev/sda", "/dev/sdb", "/dev/sdc", "/dev/sdd" })
+    {
+	Disk* disk = Disk::create(staging, name, Region(0, 1000000, 512));
+	disk->create_partition_table(PtType::GPT);
+    }
+
+    storage.remove_devicegraph("system");
+    storage.copy_devicegraph("staging", "system");
+
+    for (Disk* disk : Disk::get_all(staging))
+    {
+	PartitionTable* gpt = disk->get_partition_table();
+
+	for (unsigned int i = 1; i <= 2; ++i)
+	{
+	    Partition* partition = gpt->create_partition(disk->get_name() + to_string(i),
+							 Region(2048 + (i - 1) * 100000, 100000, 512),
+							 PartitionType::PRIMARY);
+	    partition->create_blk_filesystem(FsType::EXT4);
+	}
+    }
+
+    storage.calculate_actiongraph();
+
+    vector<string> messages;
+    CommitCallbacksRecorder commit_callbacks(messages);
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    storage.commit(CommitOptions(false, parallel_actions), &commit_callbacks);
+
+    Mockup::set_mode(Mockup::Mode::NONE);
+
+    return messages;
+}
+
+
+BOOST_AUTO_TEST_CASE(deterministic_callbacks)
+{
+    set_logger(get_stdout_logger());
+
+    vector<string> serial = commit(1);
+
+    BOOST_CHECK_EQUAL(serial.size(), 2 * 4 * (2 + 2));
+
+    vector<string> parallel = commit(4);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(parallel.begin(), parallel.end(), serial.begin(), serial.end());
+}
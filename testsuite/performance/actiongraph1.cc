@@ -0,0 +1,91 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <sstream>
+#include <iostream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Actiongraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+string
+disk_name(int i)
+{
+    ostringstream s;
+    s << "/dev/disk" << i;
+    return s.str();
+}
+
+
+void
+add_mounted_filesystem(Devicegraph* devicegraph, int i)
+{
+    Disk* disk = Disk::find_by_name(devicegraph, disk_name(i));
+
+    PartitionTable* partition_table = disk->create_partition_table(PtType::GPT);
+
+    Partition* partition = partition_table->create_partition(disk_name(i) + "p1",
+							     Region(2048, 100000, 512),
+							     PartitionType::PRIMARY);
+
+    BlkFilesystem* blk_filesystem = partition->create_blk_filesystem(FsType::EXT4);
+    blk_filesystem->create_mount_point("/test/" + to_string(i));
+}
+
+
+/**
+ * Measure the actiongraph construction for n disks each getting a mounted
+ * filesystem. Returns the time per action.
+ */
+double
+time_per_action(int n)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    for (int i = 0; i < n; ++i)
+	Disk::create(lhs, disk_name(i));
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    for (int i = 0; i < n; ++i)
+	add_mounted_filesystem(rhs, i);
+
+    Stopwatch stopwatch;
+
+    Actiongraph actiongraph(storage, lhs, rhs);
+
+    double t = stopwatch.read();
+
+    cout << n << " disks, " << actiongraph.num_actions() << " actions, " << t << " s" << endl;
+
+    return t / actiongraph.num_actions();
+}
+
+
+BOOST_AUTO_TEST_CASE(scaling)
+{
+    // Growing the number of actions by a factor of eight must not grow
+    // the time per action by anything close to that factor as a
+    // quadratic algorithm would do.
+
+    double t1 = time_per_action(250);
+    double t2 = time_per_action(2000);
+
+    BOOST_CHECK_LT(t2, 4.0 * t1);
+}
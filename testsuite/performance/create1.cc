@@ -1,4 +1,3 @@
-
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE libstorage
 
@@ -12,6 +11,8 @@
 #include "storage/Storage.h"
 #include "storage/Environment.h"
 
+#include "testsuite/helpers/Benchmark.h"
+
 
 using namespace std;
 using namespace storage;
@@ -57,23 +58,40 @@ add_partitions(Devicegraph* devicegraph, int i)
 
 BOOST_AUTO_TEST_CASE(performance)
 {
-    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+    Benchmark benchmark("create1");
+
+    for (unsigned int n : benchmark.get_sizes())
+    {
+	Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+	Storage storage(environment);
 
-    Storage storage(environment);
+	Devicegraph* lhs = storage.create_devicegraph("lhs");
 
-    Devicegraph* lhs = storage.create_devicegraph("lhs");
+	benchmark.measure("create disks", n, [lhs, n]() {
+	    for (unsigned int i = 0; i < n; ++i)
+		add_disk(lhs, i);
+	});
 
-    const int n = 1000;
+	Devicegraph* rhs = nullptr;
 
-    for (int i = 0; i < n; ++i)
-	add_disk(lhs, i);
+	benchmark.measure("copy devicegraph", n, [&storage, &rhs]() {
+	    rhs = storage.copy_devicegraph("lhs", "rhs");
+	});
 
-    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+	benchmark.measure("create partitions", n, [rhs, n]() {
+	    for (unsigned int i = 0; i < n; ++i)
+		add_partitions(rhs, i);
+	});
 
-    for (int i = 0; i < n; ++i)
-	add_partitions(rhs, i);
+	unique_ptr<Actiongraph> actiongraph;
 
-    Actiongraph actiongraph(storage, lhs, rhs);
+	benchmark.measure("actiongraph", n, [&storage, lhs, rhs, &actiongraph]() {
+	    actiongraph = make_unique<Actiongraph>(storage, lhs, rhs);
+	});
 
-    // TODO actually fail if too slow? how can that be done stable?
+	benchmark.measure("compound actions", n, [&actiongraph]() {
+	    actiongraph->generate_compound_actions();
+	});
+    }
 }
@@ -0,0 +1,106 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/FileUtils.h"
+
+#include "testsuite/helpers/Benchmark.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+void
+add_disk(Devicegraph* devicegraph, unsigned int i)
+{
+    const string name = "/dev/disk" + to_string(i);
+
+    Disk* disk = Disk::create(devicegraph, name, Region(0, 1000000, 512));
+
+    PartitionTable* gpt = disk->create_partition_table(PtType::GPT);
+
+    for (unsigned int j = 1; j < 5; ++j)
+    {
+	Partition* partition = gpt->create_partition(name + "p" + to_string(j),
+						     Region(100000 * j, 100000, 512),
+						     PartitionType::PRIMARY);
+
+	BlkFilesystem* blk_filesystem = partition->create_blk_filesystem(FsType::EXT4);
+	blk_filesystem->create_mount_point("/test/" + to_string(i) + "/" + to_string(j));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Benchmark benchmark("devicegraph1");
+
+    TmpDir tmp_dir("devicegraph1-XXXXXX");
+
+    const string filename = tmp_dir.get_fullname() + "/devicegraph.xml";
+    const string binary_filename = tmp_dir.get_fullname() + "/devicegraph.bin";
+
+    for (unsigned int n : benchmark.get_sizes())
+    {
+	Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+	Storage storage(environment);
+
+	Devicegraph* devicegraph = storage.create_devicegraph("test");
+
+	benchmark.measure("create", n, [devicegraph, n]() {
+	    for (unsigned int i = 0; i < n; ++i)
+		add_disk(devicegraph, i);
+	});
+
+	benchmark.measure("copy", n, [&storage]() {
+	    storage.copy_devicegraph("test", "copy");
+	});
+
+	benchmark.measure("check", n, [devicegraph]() {
+	    devicegraph->check();
+	});
+
+	benchmark.measure("get_unused_partition_slots", n, [devicegraph]() {
+	    for (const Disk* disk : Disk::get_all(devicegraph))
+		disk->get_partition_table()->get_unused_partition_slots();
+	});
+
+	benchmark.measure("save", n, [devicegraph, &filename]() {
+	    devicegraph->save(filename);
+	});
+
+	Devicegraph* loaded = storage.create_devicegraph("loaded");
+
+	benchmark.measure("load", n, [loaded, &filename]() {
+	    loaded->load(filename);
+	});
+
+	BOOST_CHECK_EQUAL(loaded->num_devices(), devicegraph->num_devices());
+
+	benchmark.measure("save_binary", n, [devicegraph, &binary_filename]() {
+	    devicegraph->save_binary(binary_filename);
+	});
+
+	Devicegraph* loaded_binary = storage.create_devicegraph("loaded-binary");
+
+	benchmark.measure("load_binary", n, [loaded_binary, &binary_filename]() {
+	    loaded_binary->load(binary_filename);
+	});
+
+	BOOST_CHECK(*loaded_binary == *loaded);
+
+	unlink(filename.c_str());
+	unlink(binary_filename.c_str());
+    }
+}
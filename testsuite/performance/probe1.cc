@@ -0,0 +1,143 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/StorageDefines.h"
+
+#include "testsuite/helpers/Benchmark.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Name of disk i as the kernel would name it, so sda, ..., sdz, sdaa, ...
+ */
+string
+short_name(unsigned int i)
+{
+    string tmp;
+
+    for (unsigned int j = i + 1; j > 0; j = (j - 1) / 26)
+	tmp.insert(tmp.begin(), 'a' + (j - 1) % 26);
+
+    return "sd" + tmp;
+}
+
+
+/**
+ * Creates a mockup of a system with n disks each having a GPT with two
+ * partitions.
+ */
+void
+create_mockup(unsigned int n)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    vector<string> names;
+    vector<string> lsscsi;
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+	const string name = short_name(i);
+	const string scsi = "0:0:" + to_string(i) + ":0";
+	const string path = "/devices/pci0000:00/0000:00:10.0/host0/target0:0:" + to_string(i) + "/" +
+	    scsi + "/block/" + name;
+
+	names.push_back(name);
+	lsscsi.push_back("[" + scsi + "]    disk    sas:0x5000c500" + to_string(1000000 + i) +
+			 "                /dev/" + name + " ");
+
+	Mockup::set_command("/usr/bin/stat --format '%f' '/dev/" + name + "'", { { "61b0" } });
+
+	Mockup::set_command("/usr/bin/udevadm info '/dev/" + name + "'", { {
+	    "P: " + path,
+	    "N: " + name,
+	    "S: disk/by-path/pci-0000:00:10.0-scsi-" + scsi,
+	    "E: DEVNAME=/dev/" + name,
+	    "E: DEVPATH=" + path,
+	    "E: DEVTYPE=disk",
+	    "E: SUBSYSTEM=block"
+	} });
+
+	Mockup::set_command("/usr/sbin/parted --script --machine '/dev/" + name + "' unit s print", { {
+	    "BYT;",
+	    "/dev/" + name + ":33554432s:scsi:512:512:gpt:SEAGATE ST1000NM0001:;",
+	    "1:2048s:16779263s:16777216s:::;",
+	    "2:16779264s:33552383s:16773120s:::;"
+	} });
+
+	Mockup::set_file(SYSFS_DIR + path + "/ext_range", { { "256" } });
+	Mockup::set_file(SYSFS_DIR + path + "/size", { { "33554432" } });
+	Mockup::set_file(SYSFS_DIR + path + "/alignment_offset", { { "0" } });
+	Mockup::set_file(SYSFS_DIR + path + "/ro", { { "0" } });
+	Mockup::set_file(SYSFS_DIR + path + "/queue/logical_block_size", { { "512" } });
+	Mockup::set_file(SYSFS_DIR + path + "/queue/optimal_io_size", { { "0" } });
+	Mockup::set_file(SYSFS_DIR + path + "/queue/rotational", { { "1" } });
+	Mockup::set_file(SYSFS_DIR + path + "/queue/dax", { { "0" } });
+	Mockup::set_file(SYSFS_DIR + path + "/queue/zoned", { { "none" } });
+
+	for (unsigned int j = 1; j <= 2; ++j)
+	{
+	    const string partition_name = name + to_string(j);
+
+	    Mockup::set_command("/usr/bin/udevadm info '/dev/" + partition_name + "'", { {
+		"P: " + path + "/" + partition_name,
+		"N: " + partition_name,
+		"S: disk/by-path/pci-0000:00:10.0-scsi-" + scsi + "-part" + to_string(j),
+		"E: DEVNAME=/dev/" + partition_name,
+		"E: DEVPATH=" + path + "/" + partition_name,
+		"E: DEVTYPE=partition",
+		"E: SUBSYSTEM=block"
+	    } });
+
+	    Mockup::set_file(SYSFS_DIR + path + "/" + partition_name + "/alignment_offset", { { "0" } });
+	    Mockup::set_file(SYSFS_DIR + path + "/" + partition_name + "/ro", { { "0" } });
+	}
+    }
+
+    Mockup::set_command("/bin/ls -1 --sort=none '" SYSFS_DIR "/block'", { names });
+    Mockup::set_command("/usr/bin/lsscsi --transport", { lsscsi });
+
+    Mockup::set_command("/sbin/blkid -c '/dev/null'", { {} });
+    Mockup::set_command("/usr/bin/udevadm settle --timeout=20", { {} });
+    Mockup::set_command("/usr/bin/getconf PAGESIZE", { { "4096" } });
+    Mockup::set_command("/usr/bin/test -d '/sys/firmware/efi/efivars'", { {} });
+    Mockup::set_command("/usr/bin/uname -m", { { "x86_64" } });
+    Mockup::set_command("/sbin/multipath -d -v 2 -ll", { {} });
+    Mockup::set_command("/sbin/dmraid --sets=active -ccc", { { "no raid disks" }, {}, 1 });
+    Mockup::set_command("/sbin/dmsetup table", { {} });
+
+    Mockup::set_file("/etc/fstab", { {} });
+    Mockup::set_file("/etc/crypttab", { {} });
+    Mockup::set_file("/proc/mounts", { { "/dev/root / ext4 rw,relatime 0 0" } });
+    Mockup::set_file("/proc/swaps", { { "Filename				Type		Size	Used	Priority" } });
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Benchmark benchmark("probe1");
+
+    for (unsigned int n : benchmark.get_sizes())
+    {
+	create_mockup(n);
+
+	Environment environment(true, ProbeMode::STANDARD, TargetMode::DIRECT);
+
+	Storage storage(environment);
+
+	benchmark.measure("probe", n, [&storage]() {
+	    storage.probe();
+	});
+
+	BOOST_CHECK_EQUAL(Disk::get_all(storage.get_probed()).size(), n);
+    }
+}
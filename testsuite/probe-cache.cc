@@ -0,0 +1,91 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <unistd.h>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/ProbeCache.h"
+#include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/FileUtils.h"
+#include "storage/Utils/Logger.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(cacheable)
+{
+    BOOST_CHECK(ProbeCache::is_cacheable(PARTED_BIN " --script --machine '/dev/sda' unit s print"));
+    BOOST_CHECK(ProbeCache::is_cacheable(BLKID_BIN " -c '" DEV_NULL_FILE "'"));
+    BOOST_CHECK(ProbeCache::is_cacheable(BTRFS_BIN " filesystem show"));
+
+    BOOST_CHECK(!ProbeCache::is_cacheable(BTRFS_BIN " subvolume list -a -puq (device:/dev/sda1)"));
+    BOOST_CHECK(!ProbeCache::is_cacheable(PARTED_BIN " --script '/dev/sda' mklabel gpt"));
+    BOOST_CHECK(!ProbeCache::is_cacheable(UDEVADM_BIN " info --export-db"));
+}
+
+
+BOOST_AUTO_TEST_CASE(save_and_load)
+{
+    set_logger(get_stdout_logger());
+
+    TmpDir tmp_dir("probe-cache-XXXXXX");
+    const string filename = tmp_dir.get_fullname() + "/probe-cache.xml";
+
+    const string name = PARTED_BIN " --script --machine '/dev/sda' unit s print";
+
+    RemoteCommand command;
+
+    BOOST_CHECK(!ProbeCache::lookup(name, command));
+
+    ProbeCache::activate(filename);
+    BOOST_CHECK(!ProbeCache::lookup(name, command));
+    ProbeCache::store(name, RemoteCommand({ "BYT;" }, {}, 1));
+    ProbeCache::deactivate();
+
+    BOOST_CHECK(!ProbeCache::lookup(name, command));
+
+    ProbeCache::activate(filename);
+    BOOST_CHECK(ProbeCache::lookup(name, command));
+    ProbeCache::deactivate();
+
+    BOOST_CHECK(command.stdout == vector<string>({ "BYT;" }));
+    BOOST_CHECK_EQUAL(command.exit_code, 1);
+
+    unlink(filename.c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE(outdated)
+{
+    set_logger(get_stdout_logger());
+
+    TmpDir tmp_dir("probe-cache-XXXXXX");
+    const string filename = tmp_dir.get_fullname() + "/probe-cache.xml";
+
+    const string name = BLKID_BIN " -c '" DEV_NULL_FILE "'";
+
+    ofstream out(filename);
+    out << "<?xml version=\"1.0\"?>\n"
+	"<ProbeCache>\n"
+	"  <generation>outdated</generation>\n"
+	"  <Commands>\n"
+	"    <Command>\n"
+	"      <name>" << name << "</name>\n"
+	"      <stdout>/dev/sda1: TYPE=\"swap\"</stdout>\n"
+	"    </Command>\n"
+	"  </Commands>\n"
+	"</ProbeCache>\n";
+    out.close();
+
+    RemoteCommand command;
+
+    ProbeCache::activate(filename);
+    BOOST_CHECK(!ProbeCache::lookup(name, command));
+    ProbeCache::deactivate();
+
+    unlink(filename.c_str());
+}
@@ -0,0 +1,63 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/Mockup.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+#include "storage/Devices/BlkDevice.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(reprobe)
+{
+    set_logger(get_stdout_logger());
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::load("disk-mockup.xml");
+
+    Environment environment(true, ProbeMode::STANDARD, TargetMode::DIRECT);
+
+    Storage storage(environment);
+    storage.probe();
+
+    const sid_t sda1 = BlkDevice::find_by_name(storage.get_probed(), "/dev/sda1")->get_sid();
+    const sid_t sda2 = BlkDevice::find_by_name(storage.get_probed(), "/dev/sda2")->get_sid();
+    const size_t num_devices = storage.get_probed()->num_devices();
+
+    // nothing changed on the system
+
+    ProbeChanges changes1 = storage.reprobe();
+
+    BOOST_CHECK(changes1.created.empty());
+    BOOST_CHECK(changes1.deleted.empty());
+    BOOST_CHECK(changes1.modified.empty());
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(storage.get_probed(), "/dev/sda1")->get_sid(), sda1);
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(storage.get_probed(), "/dev/sda2")->get_sid(), sda2);
+    BOOST_CHECK_EQUAL(storage.get_probed()->num_devices(), num_devices);
+
+    // the boot flag of /dev/sda2 was removed
+
+    Mockup::set_command("/usr/sbin/parted --script --machine '/dev/sda' unit s print", RemoteCommand({
+	"BYT;",
+	"/dev/sda:16777216s:scsi:512:512:msdos:ATA VBOX HARDDISK:;",
+	"1:2048s:2039807s:2037760s:linux-swap(v1)::type=82;",
+	"2:2039808s:16777215s:14737408s:ext4::type=83;"
+    }));
+
+    ProbeChanges changes2 = storage.reprobe();
+
+    BOOST_CHECK(changes2.created.empty());
+    BOOST_CHECK(changes2.deleted.empty());
+    BOOST_CHECK(changes2.modified == vector<sid_t>({ sda2 }));
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(storage.get_probed(), "/dev/sda1")->get_sid(), sda1);
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(storage.get_probed(), "/dev/sda2")->get_sid(), sda2);
+}
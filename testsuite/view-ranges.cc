@@ -0,0 +1,120 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Filesystems/BtrfsImpl.h"
+#include "storage/Filesystems/BtrfsSubvolume.h"
+#include "storage/Filesystems/BtrfsQgroup.h"
+#include "storage/Holders/HolderImpl.h"
+#include "storage/DevicegraphImpl.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Checks that the lazy ranges with the compile-time view and the
+ * functions returning vectors give the relatives visible in the view
+ * for every device.
+ */
+template <View view>
+void
+check_ranges(const Devicegraph::Impl& devicegraph)
+{
+    const Devicegraph::Impl::graph_t& graph = devicegraph.graph;
+
+    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph.vertices())
+    {
+	vector<Devicegraph::Impl::vertex_descriptor> expected_children;
+	vector<Devicegraph::Impl::edge_descriptor> expected_out_edges;
+
+	for (Devicegraph::Impl::edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	{
+	    Devicegraph::Impl::vertex_descriptor child = boost::target(edge, graph);
+
+	    if (graph[edge]->get_impl().is_in_view(view) && graph[child]->get_impl().is_in_view(view))
+	    {
+		expected_children.push_back(child);
+		expected_out_edges.push_back(edge);
+	    }
+	}
+
+	vector<Devicegraph::Impl::vertex_descriptor> expected_parents;
+	vector<Devicegraph::Impl::edge_descriptor> expected_in_edges;
+
+	for (Devicegraph::Impl::edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	{
+	    Devicegraph::Impl::vertex_descriptor parent = boost::source(edge, graph);
+
+	    if (graph[edge]->get_impl().is_in_view(view) && graph[parent]->get_impl().is_in_view(view))
+	    {
+		expected_parents.push_back(parent);
+		expected_in_edges.push_back(edge);
+	    }
+	}
+
+	auto children = devicegraph.children_range<view>(vertex);
+	auto parents = devicegraph.parents_range<view>(vertex);
+	auto out_edges = devicegraph.out_edges_range<view>(vertex);
+	auto in_edges = devicegraph.in_edges_range<view>(vertex);
+
+	BOOST_CHECK(vector<Devicegraph::Impl::vertex_descriptor>(children.begin(), children.end()) == expected_children);
+	BOOST_CHECK(vector<Devicegraph::Impl::vertex_descriptor>(parents.begin(), parents.end()) == expected_parents);
+	BOOST_CHECK(vector<Devicegraph::Impl::edge_descriptor>(out_edges.begin(), out_edges.end()) == expected_out_edges);
+	BOOST_CHECK(vector<Devicegraph::Impl::edge_descriptor>(in_edges.begin(), in_edges.end()) == expected_in_edges);
+
+	BOOST_CHECK(devicegraph.children(vertex, view) == expected_children);
+	BOOST_CHECK(devicegraph.parents(vertex, view) == expected_parents);
+	BOOST_CHECK(devicegraph.out_edges(vertex, view) == expected_out_edges);
+	BOOST_CHECK(devicegraph.in_edges(vertex, view) == expected_in_edges);
+
+	BOOST_CHECK_EQUAL(devicegraph.num_children(vertex, view), expected_children.size());
+	BOOST_CHECK_EQUAL(devicegraph.num_parents(vertex, view), expected_parents.size());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(view_ranges)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    Btrfs* btrfs = to_btrfs(sda->create_blk_filesystem(FsType::BTRFS));
+    btrfs->set_quota(true);
+
+    BtrfsSubvolume* top_level = btrfs->get_top_level_btrfs_subvolume();
+    BtrfsSubvolume* subvolume = top_level->create_btrfs_subvolume("home");
+
+    BtrfsQgroup* qgroup = btrfs->create_btrfs_qgroup(BtrfsQgroup::id_t(1, 0));
+    qgroup->assign(subvolume->get_btrfs_qgroup());
+
+    const Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
+
+    Devicegraph::Impl::vertex_descriptor vertex = btrfs->get_impl().get_vertex();
+
+    // The qgroups are only visible in View::ALL.
+
+    BOOST_CHECK_EQUAL(boost::distance(devicegraph_impl.children_range<View::ALL>(vertex)), 4);
+    BOOST_CHECK_EQUAL(boost::distance(devicegraph_impl.children_range<View::CLASSIC>(vertex)), 1);
+
+    BOOST_CHECK_EQUAL(devicegraph_impl.num_children_of_type<const BtrfsQgroup>(vertex, View::ALL), 3);
+    BOOST_CHECK_EQUAL(devicegraph_impl.num_children_of_type<const BtrfsQgroup>(vertex, View::CLASSIC), 0);
+
+    BOOST_CHECK_EQUAL(devicegraph_impl.children_of_type<const BtrfsSubvolume>(vertex).size(), 1);
+
+    check_ranges<View::ALL>(devicegraph_impl);
+    check_ranges<View::CLASSIC>(devicegraph_impl);
+    check_ranges<View::REMOVE>(devicegraph_impl);
+}
@@ -0,0 +1,79 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/BlkDeviceImpl.h"
+#include "storage/Utils/FileUtils.h"
+#include "storage/Utils/Exception.h"
+#include "storage/Utils/Logger.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+static void
+create_file(const string& name)
+{
+    FILE* fp = fopen(name.c_str(), "w");
+    BOOST_REQUIRE(fp);
+    fclose(fp);
+}
+
+
+static double
+elapsed(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+BOOST_AUTO_TEST_CASE(detach)
+{
+    set_logger(get_stdout_logger());
+
+    TmpDir tmp_dir("wait-for-devices-XXXXXX");
+
+    const vector<string> names = { tmp_dir.get_fullname() + "/a", tmp_dir.get_fullname() + "/b" };
+
+    for (const string& name : names)
+	create_file(name);
+
+    // The files disappear one after another. Waiting must end right after
+    // the last one is gone and not after polling each name on its own.
+
+    thread remover([&names]() {
+	for (const string& name : names)
+	{
+	    this_thread::sleep_for(chrono::milliseconds(200));
+	    unlink(name.c_str());
+	}
+    });
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    BOOST_CHECK_NO_THROW(wait_for_detach_devices(names));
+    BOOST_CHECK_LT(elapsed(start), 2.0);
+
+    remover.join();
+}
+
+
+BOOST_AUTO_TEST_CASE(detach_timeout)
+{
+    set_logger(get_stdout_logger());
+
+    TmpDir tmp_dir("wait-for-devices-XXXXXX");
+
+    const string name = tmp_dir.get_fullname() + "/a";
+
+    create_file(name);
+
+    BOOST_CHECK_THROW(wait_for_detach_devices(vector<string>({ name })), Exception);
+
+    unlink(name.c_str());
+}
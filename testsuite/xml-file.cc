@@ -0,0 +1,121 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <unistd.h>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Devices/DiskImpl.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Holders/HolderImpl.h"
+#include "storage/DevicegraphImpl.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/XmlFile.h"
+#include "storage/Utils/FileUtils.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Save the devicegraph by building the complete document in memory, the
+ * way Devicegraph::save() did before it wrote the file incrementally.
+ */
+static void
+save_dom(const Devicegraph* devicegraph, const string& filename)
+{
+    XmlFile xml;
+
+    xmlNode* devicegraph_node = xmlNewNode("Devicegraph");
+    xml.setRootElement(devicegraph_node);
+
+    const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+    xmlNode* devices_node = xmlNewChild(devicegraph_node, "Devices");
+
+    for (Devicegraph::Impl::vertex_descriptor vertex : impl.vertices())
+    {
+	const Device* device = impl[vertex];
+	xmlNode* device_node = xmlNewChild(devices_node, device->get_impl().get_classname());
+	device->get_impl().save(device_node);
+    }
+
+    xmlNode* holders_node = xmlNewChild(devicegraph_node, "Holders");
+
+    for (Devicegraph::Impl::edge_descriptor edge : impl.edges())
+    {
+	const Holder* holder = impl[edge];
+	xmlNode* holder_node = xmlNewChild(holders_node, holder->get_impl().get_classname());
+	holder->get_impl().save(holder_node);
+    }
+
+    BOOST_REQUIRE(xml.save_to_file(filename));
+}
+
+
+/**
+ * Read the file without comments, e.g. the one with the date.
+ */
+static vector<string>
+read_lines(const string& filename)
+{
+    vector<string> lines;
+
+    ifstream in(filename);
+    for (string line; getline(in, line); )
+    {
+	if (!boost::starts_with(line, "<!--"))
+	    lines.push_back(line);
+    }
+
+    return lines;
+}
+
+
+BOOST_AUTO_TEST_CASE(save_identical)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("test");
+
+    TmpDir tmp_dir("xml-file-XXXXXX");
+
+    const string filename1 = tmp_dir.get_fullname() + "/stream.xml";
+    const string filename2 = tmp_dir.get_fullname() + "/dom.xml";
+
+    devicegraph->save(filename1);
+    save_dom(devicegraph, filename2);
+
+    BOOST_CHECK(read_lines(filename1) == read_lines(filename2));
+
+    Disk* disk = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* gpt = disk->create_partition_table(PtType::GPT);
+
+    Partition* partition = gpt->create_partition("/dev/sda1", Region(2048, 100000, 512),
+						 PartitionType::PRIMARY);
+
+    BlkFilesystem* blk_filesystem = partition->create_blk_filesystem(FsType::EXT4);
+    blk_filesystem->set_label("h\xc3\xa4user & <g\xc3\xa4rten>");
+    blk_filesystem->create_mount_point("/test");
+
+    devicegraph->save(filename1);
+    save_dom(devicegraph, filename2);
+
+    BOOST_CHECK(read_lines(filename1) == read_lines(filename2));
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    loaded->load(filename1);
+
+    BOOST_CHECK(*loaded == *devicegraph);
+
+    unlink(filename1.c_str());
+    unlink(filename2.c_str());
+}